@@ -0,0 +1,107 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_TEMPFILES_H
+#define IVW_TEMPFILES_H
+
+#include <inviwo/core/common/inviwo.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+namespace Testing {
+
+/**
+ * Files in ::testing::TempDir() for a unit test. Every path handed out is removed when the object
+ * goes out of scope, so a test that stops at a failing ASSERT does not leave files behind.
+ */
+class TempFiles {
+public:
+    TempFiles() = default;
+    TempFiles(const TempFiles&) = delete;
+    TempFiles& operator=(const TempFiles&) = delete;
+    ~TempFiles() {
+        for (const auto& path : paths_) std::remove(path.c_str());
+    }
+
+    /**
+     * Path of name in ::testing::TempDir(), the file does not have to exist
+     */
+    std::string path(const std::string& name) {
+        paths_.push_back(::testing::TempDir() + name);
+        return paths_.back();
+    }
+
+    /**
+     * Writes the values of data to name as raw bytes and returns the path
+     */
+    template <typename T>
+    std::string writeRaw(const std::string& name, const std::vector<T>& data) {
+        const auto filename = path(name);
+        std::ofstream file(filename, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+        return filename;
+    }
+
+    /**
+     * Writes the volume name.dat and name.raw and returns the path of the .dat file. The voxels
+     * in data are in x, y, z order and format is the Format of the header, e.g. Vec3FLOAT32.
+     * extraHeader is appended to the header as is.
+     */
+    template <typename T>
+    std::string writeVolume(const std::string& name, size3_t dims, const std::string& format,
+                            const std::vector<T>& data, const std::string& extraHeader = "") {
+        writeRaw(name + ".raw", data);
+        const auto dat = path(name + ".dat");
+        std::ofstream header(dat);
+        header << "RawFile: " << name << ".raw\n"
+               << "Resolution: " << dims.x << " " << dims.y << " " << dims.z << "\n"
+               << "Format: " << format << "\n"
+               << extraHeader;
+        return dat;
+    }
+
+private:
+    std::vector<std::string> paths_;
+};
+
+}  // namespace Testing
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_TEMPFILES_H
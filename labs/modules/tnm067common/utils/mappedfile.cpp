@@ -0,0 +1,238 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067common/utils/mappedfile.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace inviwo {
+
+namespace {
+
+size_t pageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Rounds [offset, offset + length) outwards to whole pages and clamps it to the mapping. The
+// last page of the mapping may be partial, the system covers it as a whole page
+std::pair<size_t, size_t> pageRange(size_t offset, size_t length, size_t size) {
+    static const size_t page = pageSize();
+    if (offset >= size) return {0, 0};
+    const size_t last = offset + std::min(length, size - offset);
+    const size_t end = std::min((last + page - 1) / page * page, size);
+    const size_t begin = offset - offset % page;
+    return {begin, end - begin};
+}
+
+}  // namespace
+
+MappedFile MappedFile::openRead(const std::string& filename) { return {filename, 0, false}; }
+
+MappedFile MappedFile::create(const std::string& filename, size_t size) {
+    return {filename, size, true};
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename, size_t size, bool write) {
+    file_ = CreateFileA(filename.c_str(), write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                        FILE_SHARE_READ, nullptr, write ? CREATE_ALWAYS : OPEN_EXISTING,
+                        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        throw Exception("Could not open " + filename, IvwContextCustom("MappedFile"));
+    }
+    if (write) {
+        size_ = size;
+    } else {
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize)) {
+            close();
+            throw Exception("Could not read the size of " + filename,
+                            IvwContextCustom("MappedFile"));
+        }
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+    }
+    if (size_ == 0) return;  // Empty files can not be mapped, data() stays null
+
+    const auto size64 = static_cast<unsigned long long>(size_);
+    mapping_ = CreateFileMappingA(file_, nullptr, write ? PAGE_READWRITE : PAGE_READONLY,
+                                  static_cast<DWORD>(size64 >> 32),
+                                  static_cast<DWORD>(size64 & 0xffffffff), nullptr);
+    if (!mapping_) {
+        close();
+        throw Exception("Could not map " + filename, IvwContextCustom("MappedFile"));
+    }
+    data_ = static_cast<unsigned char*>(
+        MapViewOfFile(mapping_, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size_));
+    if (!data_) {
+        close();
+        throw Exception("Could not map " + filename, IvwContextCustom("MappedFile"));
+    }
+}
+
+void MappedFile::close() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+    size_ = 0;
+}
+
+void MappedFile::adviseRandom() const {}
+
+void MappedFile::prefetch(size_t, size_t) const {}
+
+void MappedFile::release(size_t offset, size_t length) const {
+    const auto range = pageRange(offset, length, size_);
+    // Removes the pages from the working set, they stay in the file cache
+    if (range.second > 0) VirtualUnlock(data_ + range.first, range.second);
+}
+
+void MappedFile::flush(size_t offset, size_t length) const {
+    const auto range = pageRange(offset, length, size_);
+    if (range.second > 0) FlushViewOfFile(data_ + range.first, range.second);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename, size_t size, bool write) {
+    file_ = ::open(filename.c_str(), write ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY, 0644);
+    if (file_ < 0) {
+        throw Exception("Could not open " + filename, IvwContextCustom("MappedFile"));
+    }
+    if (write) {
+        if (::ftruncate(file_, static_cast<off_t>(size)) != 0) {
+            close();
+            throw Exception("Could not resize " + filename, IvwContextCustom("MappedFile"));
+        }
+        size_ = size;
+    } else {
+        struct stat info;
+        if (::fstat(file_, &info) != 0) {
+            close();
+            throw Exception("Could not read the size of " + filename,
+                            IvwContextCustom("MappedFile"));
+        }
+        size_ = static_cast<size_t>(info.st_size);
+    }
+    if (size_ == 0) return;  // Empty files can not be mapped, data() stays null
+
+    void* ptr = ::mmap(nullptr, size_, write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                       file_, 0);
+    if (ptr == MAP_FAILED) {
+        close();
+        throw Exception("Could not map " + filename, IvwContextCustom("MappedFile"));
+    }
+    data_ = static_cast<unsigned char*>(ptr);
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+}
+
+void MappedFile::close() {
+    if (data_) ::munmap(data_, size_);
+    if (file_ >= 0) ::close(file_);
+    data_ = nullptr;
+    file_ = -1;
+    size_ = 0;
+}
+
+void MappedFile::adviseRandom() const {
+    if (data_) ::madvise(data_, size_, MADV_RANDOM);
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    const auto range = pageRange(offset, length, size_);
+    if (range.second > 0) ::madvise(data_ + range.first, range.second, MADV_WILLNEED);
+}
+
+void MappedFile::release(size_t offset, size_t length) const {
+    const auto range = pageRange(offset, length, size_);
+    if (range.second > 0) ::madvise(data_ + range.first, range.second, MADV_DONTNEED);
+}
+
+void MappedFile::flush(size_t offset, size_t length) const {
+    const auto range = pageRange(offset, length, size_);
+    if (range.second > 0) ::msync(data_ + range.first, range.second, MS_ASYNC);
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& rhs)
+    : data_(rhs.data_), size_(rhs.size_), file_(rhs.file_)
+#ifdef _WIN32
+    , mapping_(rhs.mapping_)
+#endif
+{
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+#ifdef _WIN32
+    rhs.file_ = nullptr;
+    rhs.mapping_ = nullptr;
+#else
+    rhs.file_ = -1;
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) {
+    if (this != &rhs) {
+        close();
+        std::swap(data_, rhs.data_);
+        std::swap(size_, rhs.size_);
+        std::swap(file_, rhs.file_);
+#ifdef _WIN32
+        std::swap(mapping_, rhs.mapping_);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() { close(); }
+
+}  // namespace inviwo
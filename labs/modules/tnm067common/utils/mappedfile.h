@@ -0,0 +1,108 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_MAPPEDFILE_H
+#define IVW_MAPPEDFILE_H
+
+#include <modules/tnm067common/tnm067commonmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <string>
+
+namespace inviwo {
+
+/**
+ * \class MappedFile
+ * \brief A file mapped into memory, read only or read/write
+ *
+ * The mapping is owned by the object and released on destruction. The hint functions take
+ * byte ranges relative to the start of the file and round them outwards to whole pages; they
+ * only advise the OS and are no-ops where the platform has no matching call.
+ * Throws an Exception if the file can not be opened or mapped.
+ */
+class IVW_MODULE_TNM067COMMON_API MappedFile {
+public:
+    /**
+     * Maps an existing file for reading
+     */
+    static MappedFile openRead(const std::string& filename);
+    /**
+     * Creates (or truncates) a file of the given size and maps it for reading and writing
+     */
+    static MappedFile create(const std::string& filename, size_t size);
+
+    MappedFile() = default;
+    MappedFile(MappedFile&& rhs);
+    MappedFile& operator=(MappedFile&& rhs);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const unsigned char* data() const { return data_; }
+    unsigned char* data() { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return data_ != nullptr; }
+
+    /**
+     * Tells the OS the file will be read in scattered ranges, which turns off read ahead so
+     * touching a range only loads its own pages. Files are opened with sequential read ahead
+     */
+    void adviseRandom() const;
+    /**
+     * Asks the OS to start reading the range from disk
+     */
+    void prefetch(size_t offset, size_t length) const;
+    /**
+     * Tells the OS the range will not be used again so its pages can be dropped. Call flush()
+     * first for written ranges
+     */
+    void release(size_t offset, size_t length) const;
+    /**
+     * Starts writing modified pages in the range back to the file without waiting for it
+     */
+    void flush(size_t offset, size_t length) const;
+
+    void close();
+
+private:
+    MappedFile(const std::string& filename, size_t size, bool write);
+
+    unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_MAPPEDFILE_H
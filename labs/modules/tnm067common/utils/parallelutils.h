@@ -0,0 +1,97 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_PARALLELUTILS_H
+#define IVW_PARALLELUTILS_H
+
+#include <modules/tnm067common/tnm067commonmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/threadpool.h>
+#include <inviwo/core/util/exception.h>
+
+#include <future>
+#include <vector>
+
+namespace inviwo {
+
+namespace util {
+
+namespace detail {
+
+// Threads in the application pool, zero if there is no application, as in the unit tests
+inline size_t poolSize() {
+    try {
+        const auto app = InviwoApplication::getPtr();
+        return app ? app->getThreadPool().getSize() : 0;
+    } catch (const Exception&) {
+        return 0;
+    }
+}
+
+}  // namespace detail
+
+/**
+ * Splits the range [0, count) into contiguous chunks and calls callback(begin, end) for each
+ * chunk on the application thread pool, the same way util::forEachPixelParallel splits an image.
+ * Intended for row based kernels, where each chunk is a block of rows. Blocks until all chunks
+ * are done and rethrows the first exception thrown by a callback. Runs on the calling thread if
+ * there is no application or its pool has no threads.
+ */
+template <typename C>
+void forEachRangeParallel(size_t count, C callback, size_t jobs = 0) {
+    if (count == 0) return;
+    const size_t threads = detail::poolSize();
+    if (threads == 0) {
+        callback(size_t(0), count);
+        return;
+    }
+    if (jobs == 0) jobs = 4 * threads;
+    jobs = std::min(jobs, count);
+
+    std::vector<std::future<void>> futures;
+    for (size_t job = 0; job < jobs; ++job) {
+        const size_t begin = job * count / jobs;
+        const size_t end = (job + 1) * count / jobs;
+        futures.push_back(dispatchPool([&callback, begin, end]() { callback(begin, end); }));
+    }
+    // Every job has to finish before leaving, they reference callback
+    for (const auto& f : futures) {
+        f.wait();
+    }
+    for (auto& f : futures) {
+        f.get();
+    }
+}
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_PARALLELUTILS_H
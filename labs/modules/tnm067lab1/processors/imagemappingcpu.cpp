@@ -29,12 +29,101 @@
 
 #include <modules/tnm067lab1/processors/imagemappingcpu.h>
 #include <modules/tnm067lab1/utils/scalartocolormapping.h>
+#include <modules/tnm067lab1/utils/colormapkernel.h>
+#include <modules/tnm067lab1/utils/tiledcolormapping.h>
+#include <modules/tnm067lab1/utils/histogrammapping.h>
+#include <modules/tnm067common/utils/parallelutils.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 #include <inviwo/core/util/indexmapper.h>
 #include <inviwo/core/util/imageramutils.h>
+#include <inviwo/core/util/exception.h>
+
+#include <chrono>
+#include <limits>
+#include <type_traits>
 
 namespace inviwo {
 
+namespace detail {
+
+// 8 and 16 bit unsigned input has few enough distinct values to precompute the output for each
+template <typename T>
+struct HasDirectLUT
+    : std::integral_constant<bool, std::is_same<T, glm::u8>::value || std::is_same<T, glm::u16>::value> {};
+
+// Maps each pixel through a table indexed like ColorMapKernel::mapRow
+template <typename T>
+void applyTable(const LayerRAMPrecision<T>& inRep, glm::u8vec4* outPixels,
+                const std::vector<glm::u8vec4>& table, std::false_type) {
+    auto inPixels = inRep.getDataTyped();
+    const glm::u8vec4* lut = table.data();
+    const size_t size = table.size();
+    util::IndexMapper2D index(inRep.getDimensions());
+    util::forEachPixelParallel(inRep, [&](size2_t pos) {
+        auto i = index(pos);
+        float inPixelVal = util::glm_convert_normalized<float>(inPixels[i]);
+        outPixels[i] = lut[TNM067::HistogramMapping::binOf(inPixelVal, size)];
+    });
+}
+
+// The table has one entry per input value
+template <typename T>
+void applyTable(const LayerRAMPrecision<T>& inRep, glm::u8vec4* outPixels,
+                const std::vector<glm::u8vec4>& table, std::true_type) {
+    const T* inPixels = inRep.getDataTyped();
+    const glm::u8vec4* lut = table.data();
+    util::IndexMapper2D index(inRep.getDimensions());
+    util::forEachPixelParallel(inRep, [&](size2_t pos) {
+        auto i = index(pos);
+        outPixels[i] = lut[inPixels[i]];
+    });
+}
+
+// Float input goes through the table one row at a time, which lets the kernel use SIMD
+inline void applyTable(const LayerRAMPrecision<float>& inRep, glm::u8vec4* outPixels,
+                       const std::vector<glm::u8vec4>& table, std::false_type) {
+    const float* inPixels = inRep.getDataTyped();
+    const size2_t dims = inRep.getDimensions();
+    util::forEachRangeParallel(dims.y, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            TNM067::ColorMapKernel::mapRow(inPixels + y * dims.x, dims.x, table.data(),
+                                           table.size(), outPixels + y * dims.x);
+        }
+    });
+}
+
+template <typename T>
+void mapPixels(const LayerRAMPrecision<T>& inRep, glm::u8vec4* outPixels, ScalarToColorMapping& map,
+               std::vector<glm::u8vec4>& /*directLUT*/, std::false_type) {
+    applyTable(inRep, outPixels, map.getLUTU8(), std::false_type{});
+}
+
+template <typename T>
+void mapPixels(const LayerRAMPrecision<T>& inRep, glm::u8vec4* outPixels, ScalarToColorMapping& map,
+               std::vector<glm::u8vec4>& directLUT, std::true_type) {
+    if (directLUT.size() != static_cast<size_t>(std::numeric_limits<T>::max()) + 1) {
+        directLUT = TNM067::ColorMapKernel::directLUT<T>(map);
+    }
+    applyTable(inRep, outPixels, directLUT, std::true_type{});
+}
+
+// Reads the input once for the histogram and once for the mapping, the transfer function is
+// folded into the table so the second pass costs the same as the linear mapping
+template <typename T>
+void mapPixelsHistogram(const LayerRAMPrecision<T>& inRep, glm::u8vec4* outPixels,
+                        ScalarToColorMapping& map, ImageMappingCPU::ColorMapping mapping,
+                        vec2 percentiles) {
+    namespace hm = TNM067::HistogramMapping;
+    const size2_t dims = inRep.getDimensions();
+    const auto hist = hm::histogram(inRep.getDataTyped(), dims.x * dims.y, hm::binsFor<T>());
+    const auto transfer = mapping == ImageMappingCPU::ColorMapping::Equalized
+                              ? hm::equalize(hist)
+                              : hm::percentileClip(hist, percentiles.x, percentiles.y);
+    applyTable(inRep, outPixels, hm::fuse(map, transfer), HasDirectLUT<T>{});
+}
+
+}  // namespace detail
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo ImageMappingCPU::processorInfo_{
     "org.inviwo.ImageMappingCPU",  // Class identifier
@@ -59,7 +148,22 @@ ImageMappingCPU::ImageMappingCPU()
                FloatVec4Property{"color7", "Color 7", vec4(1), vec4(0, 0, 0, 1), vec4(1)},
                FloatVec4Property{"color8", "Color 8", vec4(1), vec4(0, 0, 0, 1), vec4(1)},
                FloatVec4Property{"color9", "Color 9", vec4(1), vec4(0, 0, 0, 1), vec4(1)},
-               FloatVec4Property{"color10", "Color 10", vec4(1), vec4(0, 0, 0, 1), vec4(1)}}) {
+               FloatVec4Property{"color10", "Color 10", vec4(1), vec4(0, 0, 0, 1), vec4(1)}})
+    , mapping_("mapping", "Mapping",
+               {{"linear", "Linear", ColorMapping::Linear},
+                {"equalized", "Histogram Equalized", ColorMapping::Equalized},
+                {"percentile", "Percentile Clipped", ColorMapping::PercentileClip}})
+    , percentiles_("percentiles", "Percentiles", 0.02f, 0.98f, 0.0f, 1.0f)
+    , streaming_("streaming", "Streaming (Raw Files)")
+    , streamInput_("streamInput", "Input File")
+    , streamOutput_("streamOutput", "Output File (RGBA8)")
+    , streamDims_("streamDims", "Dimensions", size2_t(1024), size2_t(1), size2_t(1 << 20))
+    , streamFormat_("streamFormat", "Input Format",
+                    {{"uint8", "UInt8", DataFormatId::UInt8},
+                     {"uint16", "UInt16", DataFormatId::UInt16},
+                     {"float32", "Float32", DataFormatId::Float32}})
+    , streamTileRows_("streamTileRows", "Rows per Tile", 256, 1, 4096)
+    , streamRun_("streamRun", "Map File", InvalidationLevel::Valid) {
 
     addPort(inport_);
     addPort(outport_);
@@ -68,6 +172,7 @@ ImageMappingCPU::ImageMappingCPU()
     for (auto& c : colors_) {
         c.setSemantics(PropertySemantics::Color);
         c.setCurrentStateAsDefault();
+        c.onChange([this]() { mapDirty_ = true; });
         addProperty(c);
     }
 
@@ -78,7 +183,70 @@ ImageMappingCPU::ImageMappingCPU()
     };
 
     numColors_.onChange(colorVisibility);
+    numColors_.onChange([this]() { mapDirty_ = true; });
     colorVisibility();
+
+    addProperty(mapping_);
+    addProperty(percentiles_);
+    mapping_.onChange(
+        [this]() { percentiles_.setVisible(mapping_.get() == ColorMapping::PercentileClip); });
+    percentiles_.setVisible(false);
+
+    // Gigapixel inputs do not fit in a Layer, so they are mapped from file to file without
+    // going through the ports
+    streamOutput_.setAcceptMode(AcceptMode::Save);
+    streamRun_.onChange([this]() { mapRawFile(); });
+    streaming_.addProperty(streamInput_);
+    streaming_.addProperty(streamOutput_);
+    streaming_.addProperty(streamDims_);
+    streaming_.addProperty(streamFormat_);
+    streaming_.addProperty(streamTileRows_);
+    streaming_.addProperty(streamRun_);
+    streaming_.setCollapsed(true);
+    addProperty(streaming_);
+}
+
+void ImageMappingCPU::updateColorMap() {
+    if (!mapDirty_) return;
+    map_.clearColors();
+    for (size_t i = 0; i < numColors_.get(); i++) {
+        map_.addBaseColors(colors_[i].get());
+    }
+    map_.bake();
+    directLUT_.clear();
+    mapDirty_ = false;
+}
+
+ImageMappingCPU::~ImageMappingCPU() {
+    if (streamJob_.valid()) streamJob_.wait();
+}
+
+void ImageMappingCPU::mapRawFile() {
+    if (streamJob_.valid() &&
+        streamJob_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        LogWarn("Still mapping the previous file");
+        return;
+    }
+
+    // The job works on copies so the properties and map_ can change while it runs. It gets its
+    // own thread since the mapping itself waits on jobs in the thread pool
+    updateColorMap();
+    const std::string input = streamInput_.get();
+    const std::string output = streamOutput_.get();
+    const size2_t dims = streamDims_.get();
+    const DataFormatId format = streamFormat_.get();
+    const size_t tileRows = streamTileRows_.get();
+    streamJob_ = std::async(std::launch::async, [=, map = map_]() mutable {
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            TNM067::TiledColorMapping::mapRawFile(input, output, dims, format, map, tileRows);
+            const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+            LogInfo("Mapped " << input << " to " << output << " in " << time.count() << " s");
+        } catch (const Exception& e) {
+            LogError(e.getMessage());
+        }
+    });
+    LogInfo("Mapping " << input << " in the background");
 }
 
 void ImageMappingCPU::process() {
@@ -87,20 +255,17 @@ void ImageMappingCPU::process() {
     auto outRep = static_cast<LayerRAMPrecision<glm::u8vec4>*>(
         img->getColorLayer()->getEditableRepresentation<LayerRAM>());
     glm::u8vec4* outPixels = outRep->getDataTyped();
-    util::IndexMapper2D index(inImg->getDimensions());
 
-    ScalarToColorMapping map;
-    for (size_t i = 0; i < numColors_.get(); i++) {
-        map.addBaseColors(colors_[i].get());
-    }
+    updateColorMap();
 
     inImg->getColorLayer()->getRepresentation<LayerRAM>()->dispatch<void>([&](const auto inRep) {
-        auto inPixels = inRep->getDataTyped();
-        util::forEachPixelParallel(*inRep, [&](size2_t pos) {
-            auto i = index(pos);
-            float inPixelVal = util::glm_convert_normalized<float>(inPixels[i]);
-			outPixels[i] = map.sample(inPixelVal)*255.f;
-        });
+        using T = typename std::decay<decltype(*inRep->getDataTyped())>::type;
+        if (mapping_.get() == ColorMapping::Linear) {
+            detail::mapPixels(*inRep, outPixels, map_, directLUT_, detail::HasDirectLUT<T>{});
+        } else {
+            detail::mapPixelsHistogram(*inRep, outPixels, map_, mapping_.get(),
+                                       percentiles_.get());
+        }
     });
 
     outport_.setData(img);
@@ -34,7 +34,15 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/minmaxproperty.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/fileproperty.h>
+#include <inviwo/core/properties/buttonproperty.h>
 #include <inviwo/core/ports/imageport.h>
+#include <modules/tnm067lab1/utils/scalartocolormapping.h>
+
+#include <future>
 
 namespace inviwo {
 
@@ -61,22 +69,43 @@ namespace inviwo {
  */
 class IVW_MODULE_TNM067LAB1_API ImageMappingCPU : public Processor { 
 public:
+    // How normalized input values are placed on the colormap
+    enum class ColorMapping { Linear, Equalized, PercentileClip };
+
     ImageMappingCPU();
-    virtual ~ImageMappingCPU() = default;
+    virtual ~ImageMappingCPU();
      
     virtual void process() override;
 
     virtual const ProcessorInfo getProcessorInfo() const override;
     static const ProcessorInfo processorInfo_;
 private:
+    // Rebuilds and bakes map_ from the color properties if any of them changed
+    void updateColorMap();
+    // Starts mapping the raw file in the streaming properties tile by tile on a background
+    // thread, see TiledColorMapping. The result is reported in the log
+    void mapRawFile();
+
     ImageInport inport_;
     ImageOutport outport_;
 
     IntSizeTProperty numColors_;
     std::array<FloatVec4Property,10> colors_;
+    TemplateOptionProperty<ColorMapping> mapping_;
+    FloatMinMaxProperty percentiles_;
+
+    CompositeProperty streaming_;
+    FileProperty streamInput_;
+    FileProperty streamOutput_;
+    IntSize2Property streamDims_;
+    TemplateOptionProperty<DataFormatId> streamFormat_;
+    IntSizeTProperty streamTileRows_;
+    ButtonProperty streamRun_;
+    std::future<void> streamJob_;  // The running mapRawFile job, if any
 
-        
-    
+    ScalarToColorMapping map_;
+    bool mapDirty_ = true;
+    std::vector<glm::u8vec4> directLUT_;  // One entry per input value for 8 and 16 bit input
 };
 
 } // namespace
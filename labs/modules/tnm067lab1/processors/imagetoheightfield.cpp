@@ -33,12 +33,38 @@
 
 #include <modules/tnm067lab1/processors/imagetoheightfield.h>
 #include <modules/tnm067lab1/utils/scalartocolormapping.h>
+#include <modules/tnm067lab1/utils/terrainlod.h>
+#include <modules/tnm067lab1/utils/heightfieldmesh.h>
 #include <inviwo/core/util/imageramutils.h>
+#include <inviwo/core/util/glmconvert.h>
 #include <inviwo/core/datastructures/image/layerram.h>
+#include <modules/tnm067common/utils/parallelutils.h>
 
 
 namespace inviwo {
 
+namespace detail {
+
+// Reads all values of the layer as getAsDouble would, through a typed pointer to each row
+std::vector<float> readValues(const LayerRAM& img) {
+    const size2_t dims = img.getDimensions();
+    std::vector<float> values(dims.x * dims.y);
+    img.dispatch<void>([&](const auto layer) {
+        using T = typename std::decay<decltype(*layer->getDataTyped())>::type;
+        const T* data = layer->getDataTyped();
+        util::forEachRangeParallel(dims.y, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; y++) {
+                const T* row = data + y * dims.x;
+                float* out = values.data() + y * dims.x;
+                for (size_t x = 0; x < dims.x; x++) out[x] = util::glm_convert<float>(row[x]);
+            }
+        });
+    });
+    return values;
+}
+
+}  // namespace detail
+
 
 const ProcessorInfo ImageToHeightfield::processorInfo_{
     "org.inviwo.ImageToHeightfield",  // Class identifier
@@ -56,6 +82,11 @@ ImageToHeightfield::ImageToHeightfield()
     , imageInport_("imageInport")
     , meshOutport_("meshOutport")
     , heightScaleFactor_("heightScaleFactor", "Height Scale Factor", 1.0f, 0.001f, 2.0f, 0.001f) 
+    , meshMode_("meshMode", "Mesh",
+                {{"columns", "Columns", MeshMode::Columns},
+                 {"smooth", "Smooth (Shared Grid)", MeshMode::Smooth},
+                 {"adaptive", "Adaptive (Quadtree LOD)", MeshMode::Adaptive}})
+    , lodError_("lodError", "Max LOD Error", 0.01f, 0.0f, 0.5f, 0.001f)
     , numColors_("numColors", "Number of colors", 2, 1, 10)
     , colors_({FloatVec4Property{"color1", "Color 1", vec4(0, 0, 0, 1), vec4(0, 0, 0, 1), vec4(1)},
         FloatVec4Property{"color2", "Color 2", vec4(1), vec4(0, 0, 0, 1), vec4(1)},
@@ -71,11 +102,18 @@ ImageToHeightfield::ImageToHeightfield()
     addPort(imageInport_);
     addPort(meshOutport_);
     addProperty(heightScaleFactor_);
+    addProperty(meshMode_);
+    addProperty(lodError_);
+    meshMode_.onChange([this]() { lodError_.setVisible(meshMode_.get() == MeshMode::Adaptive); });
+    meshMode_.onChange([this]() { topologyDirty_ = true; });
+    lodError_.onChange([this]() { topologyDirty_ = true; });
+    lodError_.setVisible(false);
 
     addProperty(numColors_);
     for (auto& c : colors_) {
         c.setSemantics(PropertySemantics::Color);
         c.setCurrentStateAsDefault();
+        c.onChange([this]() { mapDirty_ = colorsDirty_ = true; });
         addProperty(c);
     }
 
@@ -86,181 +124,148 @@ ImageToHeightfield::ImageToHeightfield()
     };
 
     numColors_.onChange(colorVisibility);
+    numColors_.onChange([this]() { mapDirty_ = colorsDirty_ = true; });
     colorVisibility();
 
 }
 
+void ImageToHeightfield::updateColorMap() {
+    if (!mapDirty_) return;
+    map_.clearColors();
+    for (size_t i = 0; i < numColors_.get(); i++) {
+        map_.addBaseColors(colors_[i].get());
+    }
+    map_.bake();
+    mapDirty_ = false;
+}
+
 void ImageToHeightfield::process() {
-    buildMesh();
+    if (!mesh_ || topologyDirty_ || imageInport_.isChanged()) {
+        switch (meshMode_.get()) {
+            case MeshMode::Smooth:
+                buildSmoothMesh();
+                break;
+            case MeshMode::Adaptive:
+                buildAdaptiveMesh();
+                break;
+            default:
+                buildMesh();
+                break;
+        }
+        meshScale_ = heightScaleFactor_.get();
+        topologyDirty_ = false;
+        colorsDirty_ = false;
+    } else {
+        if (heightScaleFactor_.get() != meshScale_) updateHeights();
+        if (colorsDirty_) updateColors();
+    }
     meshOutport_.setData(mesh_);
 }
 
-void ImageToHeightfield::buildMesh() {
-    auto inImage = imageInport_.getData();
-    auto dims = inImage->getDimensions();
+// All heights in the mesh are proportional to the scale, and a positive scale keeps the order
+// of neighbouring columns, so the visible walls stay the same and only y has to be rescaled.
+// The normals of the smooth meshes are rescaled the same way through the slope they encode.
+void ImageToHeightfield::updateHeights() {
+    const float factor = heightScaleFactor_.get() / meshScale_;
+    auto& positions =
+        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
+    auto& texCoords =
+        mesh_->getEditableTexCoords()->getEditableRAMRepresentation()->getDataContainer();
+    auto& normals =
+        mesh_->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer();
+    const bool rescaleNormals = meshMode_.get() != MeshMode::Columns;
+
+    util::forEachRangeParallel(positions.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            positions[i].y *= factor;
+            texCoords[i].y *= factor;
+            if (rescaleNormals) {
+                const vec3& n = normals[i];
+                normals[i] = glm::normalize(vec3(n.x * factor, n.y, n.z * factor));
+            }
+        }
+    });
+    meshScale_ = heightScaleFactor_.get();
+}
 
-    mesh_ = std::make_shared<BasicMesh>();
+void ImageToHeightfield::updateColors() {
+    updateColorMap();
+    auto& colors = mesh_->getEditableColors()->getEditableRAMRepresentation()->getDataContainer();
+    util::forEachRangeParallel(colors.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            colors[i] = map_.lookup(vertexValues_[i]);
+        }
+    });
+    colorsDirty_ = false;
+}
 
+void ImageToHeightfield::setMesh(TNM067::HeightfieldMesh::Buffers buffers) {
+    mesh_ = std::make_shared<BasicMesh>();
     auto ib = mesh_->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
-    std::vector<BasicMesh::Vertex> vertices;
-    auto &ibVector = ib->getDataContainer();
-    
-    auto bufferSize = 24 * dims.x * dims.y;
-    ibVector.reserve(bufferSize);
-    vertices.reserve(bufferSize);
-	
-    ScalarToColorMapping map;
-    for (size_t i = 0; i < numColors_.get(); i++) {
-        map.addBaseColors(colors_[i].get());
-    }
-
-
-    vec2 cellSize = 1.0f / vec2(dims);
-    auto img = inImage->getColorLayer()->getRepresentation<LayerRAM>();
-    util::forEachPixel(*img, [&](const size2_t &pos) {
-        unsigned int startID = static_cast<unsigned int>( vertices.size());
-
-        vec2 origin2D = vec2(pos)*cellSize;
-        vec3 origin(origin2D.x,0.0f, origin2D.y);
-        
-        double height = img->getAsDouble(pos)*heightScaleFactor_;
-
-        vec4 color(1,1,1,1);
-		color = map.sample(img->getAsDouble(pos));
-
-        /****************************************
-        BOTTOM
-        *****************************************/
-        vertices.push_back({ origin + vec3(0,0,0) , vec3(0,-1,0) , origin + vec3(0,0,0) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,0,0) , vec3(0,-1,0) , origin + vec3(cellSize.x,0,0) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,0,cellSize.y) , vec3(0,-1,0) , origin + vec3(cellSize.x,0,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(0,0,cellSize.y) , vec3(0,-1,0) , origin + vec3(0,0,cellSize.y) , color });
-
-        ib->add({
-            startID + 0,
-            startID + 1,
-            startID + 2,
-
-            startID + 0,
-            startID + 2,
-            startID + 3
-        });
-
-
-
-        /****************************************
-        TOP
-        *****************************************/
-        startID = static_cast<unsigned int>(vertices.size());
-        vertices.push_back({ origin + vec3(0,height,0) , vec3(0,1,0) , origin + vec3(0,height,0) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,height,0) , vec3(0,1,0) , origin + vec3(cellSize.x,height,0) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,height,cellSize.y) , vec3(0,1,0) , origin + vec3(cellSize.x,height,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(0,height,cellSize.y) , vec3(0,1,0) , origin + vec3(0,height,cellSize.y) , color });
-
-        ib->add({
-            startID + 0,
-            startID + 1,
-            startID + 2,
-
-            startID + 0,
-            startID + 2,
-            startID + 3
-        });
-
-
-
-
-        /****************************************
-        LEFT
-        *****************************************/
-        startID = static_cast<unsigned int>(vertices.size());
-        vertices.push_back({ origin + vec3(0,0,0) , vec3(-1,0,0) , origin + vec3(0,0,0) , color });
-        vertices.push_back({ origin + vec3(0,0,cellSize.y) , vec3(-1,0,0) , origin + vec3(0,0,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(0,height,cellSize.y) , vec3(-1,0,0) , origin + vec3(0,height,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(0,height,0) , vec3(-1,0,0) , origin + vec3(0,height,0) , color });
-
-        ib->add({
-            startID + 0,
-            startID + 1,
-            startID + 2,
-
-            startID + 0,
-            startID + 2,
-            startID + 3
-        });
-
-
-        /****************************************
-        RIGHT
-        *****************************************/
-        startID = static_cast<unsigned int>(vertices.size());
-        vertices.push_back({ origin + vec3(cellSize.x,0,0)          , vec3(1,0,0) , origin + vec3(cellSize.x,0,0) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,0,cellSize.y) , vec3(1,0,0) , origin + vec3(cellSize.x,0,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,height,cellSize.y) , vec3(1,0,0) , origin + vec3(cellSize.x,height,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,height,0) , vec3(1,0,0) , origin + vec3(cellSize.x,height,0) , color });
-
-        ib->add({
-            startID + 0,
-            startID + 1,
-            startID + 2,
-
-            startID + 0,
-            startID + 2,
-            startID + 3
-        });
-
-
-
-
-        /****************************************
-        FRONT
-        *****************************************/
-        startID = static_cast<unsigned int>(vertices.size());
-        vertices.push_back({ origin + vec3(0,0,0) , vec3(0,0,-1) , origin + vec3(0,0,0) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,0,0) , vec3(0,0,-1) , origin + vec3(cellSize.x,0,0) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,height,0) , vec3(0,0,-1) , origin + vec3(cellSize.x,height,0) , color });
-        vertices.push_back({ origin + vec3(0,height,0) , vec3(0,0,-1) , origin + vec3(0,height,0) , color });
-
-        ib->add({
-            startID + 0,
-            startID + 1,
-            startID + 2,
-
-            startID + 0,
-            startID + 2,
-            startID + 3
-        });
-
-
-
+    ib->getDataContainer() = std::move(buffers.indices);
+    mesh_->addVertices(buffers.vertices);
+    vertexValues_ = std::move(buffers.values);
+}
 
+void ImageToHeightfield::buildMesh() {
+    updateColorMap();
+    const auto img = imageInport_.getData()->getColorLayer()->getRepresentation<LayerRAM>();
+    setMesh(TNM067::HeightfieldMesh::columns(detail::readValues(*img), img->getDimensions(),
+                                             heightScaleFactor_.get(), map_));
+}
 
-        /****************************************
-        BACK
-        *****************************************/
-        startID = static_cast<unsigned int>(vertices.size());
-        vertices.push_back({ origin + vec3(0,0,cellSize.y) , vec3(0,0,1) , origin + vec3(0,0,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,0,cellSize.y) , vec3(0,0,1) , origin + vec3(cellSize.x,0,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(cellSize.x,height,cellSize.y) , vec3(0,0,1) , origin + vec3(cellSize.x,height,cellSize.y) , color });
-        vertices.push_back({ origin + vec3(0,height,cellSize.y) , vec3(0,0,1) , origin + vec3(0,height,cellSize.y) , color });
+// One vertex and about two triangles per pixel instead of a box of quads per pixel
+void ImageToHeightfield::buildSmoothMesh() {
+    updateColorMap();
+    const auto img = imageInport_.getData()->getColorLayer()->getRepresentation<LayerRAM>();
+    setMesh(TNM067::HeightfieldMesh::grid(detail::readValues(*img), img->getDimensions(),
+                                          heightScaleFactor_.get(), map_));
+}
 
-        ib->add({
-            startID + 0,
-            startID + 1,
-            startID + 2,
+// The same surface as buildSmoothMesh, triangulated by TerrainLOD so the triangle count
+// follows the complexity of the terrain instead of the number of pixels. The normals are
+// averaged from the triangles around each vertex, since the patches vary in size.
+void ImageToHeightfield::buildAdaptiveMesh() {
+    updateColorMap();
+
+    const auto img = imageInport_.getData()->getColorLayer()->getRepresentation<LayerRAM>();
+    const size2_t dims = img->getDimensions();
+    auto lod = TNM067::TerrainLOD::build(detail::readValues(*img), dims, lodError_.get());
+
+    const vec2 cellSize = 1.0f / vec2(dims);
+    const float scale = heightScaleFactor_.get();
+    std::vector<vec3> positions(lod.vertices.size());
+    for (size_t i = 0; i < lod.vertices.size(); i++) {
+        const vec3& v = lod.vertices[i];
+        const vec2 origin2D = (vec2(v.x, v.y) + 0.5f) * cellSize;
+        positions[i] = vec3(origin2D.x, v.z * scale, origin2D.y);
+    }
 
-            startID + 0,
-            startID + 2,
-            startID + 3
-        });
+    // Area weighted, the cross product is twice the area of the triangle
+    std::vector<vec3> normals(positions.size(), vec3(0.0f));
+    for (size_t t = 0; t + 2 < lod.indices.size(); t += 3) {
+        const auto a = lod.indices[t];
+        const auto b = lod.indices[t + 1];
+        const auto c = lod.indices[t + 2];
+        const vec3 n = glm::cross(positions[c] - positions[a], positions[b] - positions[a]);
+        normals[a] += n;
+        normals[b] += n;
+        normals[c] += n;
+    }
 
-        
+    TNM067::HeightfieldMesh::Buffers buffers;
+    buffers.vertices.resize(positions.size());
+    buffers.values.resize(positions.size());
+    util::forEachRangeParallel(positions.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const vec3 normal = glm::normalize(normals[i]);
+            buffers.values[i] = lod.vertices[i].z;
+            const vec4 color = map_.lookup(lod.vertices[i].z);
+            buffers.vertices[i] = BasicMesh::Vertex{positions[i], normal, positions[i], color};
+        }
     });
-
-
-    mesh_->addVertices(vertices);
-
+    buffers.indices = std::move(lod.indices);
+    setMesh(std::move(buffers));
 }
 
 }  // namespace
-
@@ -34,16 +34,24 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/core/ports/meshport.h>
 #include <modules/base/properties/gaussianproperty.h>
 #include <modules/tnm067lab1/utils/scalartocolormapping.h>
+#include <modules/tnm067lab1/utils/heightfieldmesh.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
 
 namespace inviwo {
 
 class IVW_MODULE_TNM067LAB1_API ImageToHeightfield : public Processor {
 public:
+    enum class MeshMode {
+        Columns,  // One box per pixel
+        Smooth,   // One shared vertex per pixel, connected by a triangle grid
+        Adaptive  // Like Smooth, but with larger patches where the terrain is flat
+    };
+
     ImageToHeightfield();
     virtual ~ImageToHeightfield() = default;
 
@@ -53,16 +61,35 @@ public:
     static const ProcessorInfo processorInfo_;
 
     void buildMesh();
+    void buildSmoothMesh();
+    void buildAdaptiveMesh();
 
 private:
+    // Replaces mesh_ and vertexValues_ with the content of buffers
+    void setMesh(TNM067::HeightfieldMesh::Buffers buffers);
+    // Rebuilds and bakes map_ from the color properties if any of them changed
+    void updateColorMap();
+    // Patch the existing mesh in place when only the height scale or the colors changed
+    void updateHeights();
+    void updateColors();
+
     ImageInport imageInport_;
     MeshOutport meshOutport_;
     FloatProperty heightScaleFactor_;
+    TemplateOptionProperty<MeshMode> meshMode_;
+    FloatProperty lodError_;
 
     IntSizeTProperty numColors_;
     std::array<FloatVec4Property,10> colors_;
 
     std::shared_ptr<BasicMesh> mesh_;
+    std::vector<float> vertexValues_;  // Input value of each vertex, for recoloring
+    float meshScale_ = 1.0f;           // Height scale mesh_ was built or patched with
+    bool topologyDirty_ = true;
+    bool colorsDirty_ = false;
+
+    ScalarToColorMapping map_;
+    bool mapDirty_ = true;
 };
 
 }  // namespace inviwo
@@ -35,6 +35,8 @@
 #include <modules/opengl/texture/textureutils.h>
 #include <modules/tnm067lab1/processors/imageupsampler.h>
 #include <modules/tnm067lab1/utils/interpolationmethods.h>
+#include <modules/tnm067lab1/utils/downsampling.h>
+#include <modules/tnm067lab1/utils/resampling.h>
 #include <inviwo/core/datastructures/image/layerram.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 #include <inviwo/core/util/imageramutils.h>
@@ -108,6 +110,40 @@ namespace inviwo {
             });
         }
         
+        // Box filter / area averaging, used for minification. Halves through a mip chain and
+        // resolves the remaining scale factor with an area weighted average
+        template<typename T>
+        void areaAverage(const LayerRAMPrecision<T> &inputImage, LayerRAMPrecision<T> &outputImage){
+            TNM067::Downsampling::downsample(inputImage.getDataTyped(), inputImage.getDimensions(),
+                                             outputImage.getDataTyped(), outputImage.getDimensions());
+        }
+        
+        template<typename T>
+        void resample( ImageUpsampler::IntepolationMethod  method ,
+                      const LayerRAMPrecision<T> &inputImage, LayerRAMPrecision<T> &outputImage){
+            const T* in = inputImage.getDataTyped();
+            T* out = outputImage.getDataTyped();
+            const size2_t inSize = inputImage.getDimensions();
+            const size2_t outSize = outputImage.getDimensions();
+            switch (method) {
+                case ImageUpsampler::IntepolationMethod::AreaAverage:
+                    areaAverage(inputImage, outputImage);
+                    break;
+                case ImageUpsampler::IntepolationMethod::Bicubic:
+                    TNM067::Resampling::catmullRom(in, inSize, out, outSize);
+                    break;
+                case ImageUpsampler::IntepolationMethod::Mitchell:
+                    TNM067::Resampling::mitchell(in, inSize, out, outSize);
+                    break;
+                case ImageUpsampler::IntepolationMethod::Lanczos3:
+                    TNM067::Resampling::lanczos3(in, inSize, out, outSize);
+                    break;
+                default:
+                    upsample(method, inputImage, outputImage);
+                    break;
+            }
+        }
+        
     }
     
     
@@ -131,6 +167,10 @@ namespace inviwo {
                                {"bilinear", "Bilinear", IntepolationMethod::Bilinear},
                                {"quadratic", "Quadratic", IntepolationMethod::Quadratic},
                                {"barycentric", "Barycentric", IntepolationMethod::Barycentric},
+                               {"areaaverage", "Area Average (Box Filter)", IntepolationMethod::AreaAverage},
+                               {"bicubic", "Bicubic (Catmull-Rom)", IntepolationMethod::Bicubic},
+                               {"mitchell", "Bicubic (Mitchell-Netravali)", IntepolationMethod::Mitchell},
+                               {"lanczos3", "Lanczos-3", IntepolationMethod::Lanczos3},
                            }){
                                addPort(inport_);
                                addPort(outport_);
@@ -150,7 +190,7 @@ namespace inviwo {
         outputImage->getColorLayer()->setSwizzleMask(inputImage->getColorLayer()->getSwizzleMask());
         outputImage->getColorLayer()->getEditableRepresentation<LayerRAM>()->dispatch<void,dispatching::filter::Scalars>([&](auto outRep){
             auto inRep = inputImage->getColorLayer()->getRepresentation<LayerRAM>();
-            detail::upsample(interpolationMethod_.get(), *(const decltype(outRep))(inRep), *outRep);
+            detail::resample(interpolationMethod_.get(), *(const decltype(outRep))(inRep), *outRep);
         });
         
         outport_.setData(outputImage);
@@ -46,7 +46,11 @@ public:
         PiecewiseConstant ,
         Bilinear ,
         Quadratic , 
-        Barycentric 
+        Barycentric ,
+        AreaAverage ,
+        Bicubic ,
+        Mitchell ,
+        Lanczos3
     };
 
 
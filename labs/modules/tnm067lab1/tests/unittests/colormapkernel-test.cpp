@@ -0,0 +1,150 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/colormapkernel.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<glm::u8vec4> testLUT(size_t size) {
+    std::vector<glm::u8vec4> lut(size);
+    for (size_t i = 0; i < size; i++) {
+        const auto v = static_cast<glm::u8>(i % 256);
+        lut[i] = glm::u8vec4(v, 255 - v, static_cast<glm::u8>(i / 256), 255);
+    }
+    return lut;
+}
+
+}  // namespace
+
+TEST(ColorMapKernelTests, MatchesScalarTest) {
+    const auto lut = testLUT(4096);
+
+    // Exact table positions, values in between, out of range values and NaN. The odd length
+    // makes sure the scalar tail after the last full SIMD batch is used as well
+    std::vector<float> in;
+    for (size_t i = 0; i < lut.size(); i++) {
+        in.push_back(i / 4095.0f);
+        in.push_back((i + 0.3f) / 4095.0f);
+    }
+    in.push_back(-1.0f);
+    in.push_back(2.0f);
+    in.push_back(std::numeric_limits<float>::quiet_NaN());
+    in.push_back(std::numeric_limits<float>::infinity());
+    in.push_back(-std::numeric_limits<float>::infinity());
+
+    std::vector<glm::u8vec4> vectorized(in.size());
+    std::vector<glm::u8vec4> scalar(in.size());
+    TNM067::ColorMapKernel::mapRow(in.data(), in.size(), lut.data(), lut.size(),
+                                   vectorized.data());
+    TNM067::ColorMapKernel::mapRowScalar(in.data(), in.size(), lut.data(), lut.size(),
+                                         scalar.data());
+
+    for (size_t i = 0; i < in.size(); i++) {
+        EXPECT_EQ(scalar[i], vectorized[i]) << "at index " << i << " value " << in[i];
+    }
+    for (size_t i = 0; i < lut.size(); i++) {
+        EXPECT_EQ(lut[i], scalar[2 * i]);
+    }
+
+    const size_t n = in.size();
+    EXPECT_EQ(lut.front(), scalar[n - 5]);
+    EXPECT_EQ(lut.back(), scalar[n - 4]);
+    EXPECT_EQ(lut.front(), scalar[n - 3]);
+    EXPECT_EQ(lut.back(), scalar[n - 2]);
+    EXPECT_EQ(lut.front(), scalar[n - 1]);
+}
+
+// Rows of every length around the SIMD batch size, starting at unaligned positions
+TEST(ColorMapKernelTests, RowLengthTest) {
+    const auto lut = testLUT(300);
+
+    std::vector<float> in(64);
+    for (size_t i = 0; i < in.size(); i++) in[i] = (i * 37 % 64) / 63.0f;
+
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t length = 0; offset + length <= in.size() && length <= 40; length++) {
+            std::vector<glm::u8vec4> vectorized(length + 1, glm::u8vec4(7));
+            std::vector<glm::u8vec4> scalar(length + 1, glm::u8vec4(7));
+            TNM067::ColorMapKernel::mapRow(in.data() + offset, length, lut.data(), lut.size(),
+                                           vectorized.data());
+            TNM067::ColorMapKernel::mapRowScalar(in.data() + offset, length, lut.data(),
+                                                 lut.size(), scalar.data());
+            EXPECT_EQ(scalar, vectorized) << "offset " << offset << " length " << length;
+            EXPECT_EQ(glm::u8vec4(7), vectorized.back()) << "Wrote past the end of the row";
+        }
+    }
+}
+
+// Benchmark, not part of the unit test run. Reports the throughput of both paths on a 4096x1024
+// float image, run it with
+//   --gtest_also_run_disabled_tests --gtest_filter=ColorMapKernelTests.DISABLED_ThroughputBenchmark
+TEST(ColorMapKernelTests, DISABLED_ThroughputBenchmark) {
+    const size_t width = 4096;
+    const size_t height = 1024;
+    const auto lut = testLUT(4096);
+
+    std::vector<float> in(width * height);
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = static_cast<float>(i % 9973) / 9972.0f;
+    }
+    std::vector<glm::u8vec4> out(in.size());
+
+    auto measure = [&](auto kernel) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (size_t y = 0; y < height; y++) {
+            kernel(in.data() + y * width, width, lut.data(), lut.size(), out.data() + y * width);
+        }
+        const std::chrono::duration<double> time =
+            std::chrono::high_resolution_clock::now() - start;
+        return static_cast<double>(width * height) / time.count() / 1.0e6;
+    };
+
+    const double scalar = measure(&TNM067::ColorMapKernel::mapRowScalar);
+    const double vectorized = measure(&TNM067::ColorMapKernel::mapRow);
+
+    std::cout << "ColorMapKernel scalar: " << scalar << " MP/s, mapRow ("
+              << (TNM067::ColorMapKernel::isVectorized() ? "AVX2" : "scalar")
+              << "): " << vectorized << " MP/s" << std::endl;
+    EXPECT_GT(vectorized, 0.0);
+}
+
+}  // namespace inviwo
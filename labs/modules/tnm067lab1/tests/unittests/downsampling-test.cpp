@@ -0,0 +1,109 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/downsampling.h>
+
+namespace inviwo {
+
+TEST(DownsamplingTests, HalveEvenTest) {
+    std::vector<float> in = {0, 1, 2, 3,
+                             4, 5, 6, 7};
+    std::vector<float> out(2);
+    TNM067::Downsampling::halve(in.data(), size2_t(4, 2), out.data());
+    EXPECT_FLOAT_EQ(2.5f, out[0]);
+    EXPECT_FLOAT_EQ(4.5f, out[1]);
+}
+
+TEST(DownsamplingTests, HalveOddTest) {
+    std::vector<float> in = {0, 1, 2,
+                             3, 4, 5,
+                             6, 7, 8};
+    float out;
+    TNM067::Downsampling::halve(in.data(), size2_t(3, 3), &out);
+    EXPECT_FLOAT_EQ(4.0f, out);
+}
+
+TEST(DownsamplingTests, HalveUInt8Test) {
+    std::vector<std::uint8_t> in = {0, 255, 255, 0};
+    std::uint8_t out;
+    TNM067::Downsampling::halve(in.data(), size2_t(2, 2), &out);
+    EXPECT_EQ(128, out);
+}
+
+TEST(DownsamplingTests, AreaAverageTest) {
+    std::vector<double> in(7 * 5);
+    double mean = 0;
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = static_cast<double>(i);
+        mean += in[i] / in.size();
+    }
+
+    std::vector<double> same(in.size());
+    TNM067::Downsampling::areaAverage(in.data(), size2_t(7, 5), same.data(), size2_t(7, 5));
+    for (size_t i = 0; i < in.size(); i++) {
+        EXPECT_DOUBLE_EQ(in[i], same[i]);
+    }
+
+    double single;
+    TNM067::Downsampling::areaAverage(in.data(), size2_t(7, 5), &single, size2_t(1, 1));
+    EXPECT_DOUBLE_EQ(mean, single);
+
+    // 7 -> 2 covers columns [0, 3.5) and [3.5, 7)
+    std::vector<double> row = {0, 1, 2, 3, 4, 5, 6};
+    std::vector<double> two(2);
+    TNM067::Downsampling::areaAverage(row.data(), size2_t(7, 1), two.data(), size2_t(2, 1));
+    EXPECT_DOUBLE_EQ((0 + 1 + 2 + 3 * 0.5) / 3.5, two[0]);
+    EXPECT_DOUBLE_EQ((3 * 0.5 + 4 + 5 + 6) / 3.5, two[1]);
+}
+
+TEST(DownsamplingTests, MipChainTest) {
+    std::vector<float> in(16 * 8, 0.5f);
+    auto chain = TNM067::Downsampling::mipChain(in.data(), size2_t(16, 8));
+    ASSERT_EQ(3, chain.size());
+    EXPECT_EQ(size2_t(8, 4), chain[0].size);
+    EXPECT_EQ(size2_t(4, 2), chain[1].size);
+    EXPECT_EQ(size2_t(2, 1), chain[2].size);
+    for (auto& level : chain) {
+        ASSERT_EQ(level.size.x * level.size.y, level.data.size());
+        for (auto& v : level.data) {
+            EXPECT_FLOAT_EQ(0.5f, v);
+        }
+    }
+
+    auto limited = TNM067::Downsampling::mipChain(in.data(), size2_t(16, 8), size2_t(4, 4));
+    ASSERT_EQ(1, limited.size());
+    EXPECT_EQ(size2_t(8, 4), limited[0].size);
+}
+
+}  // namespace inviwo
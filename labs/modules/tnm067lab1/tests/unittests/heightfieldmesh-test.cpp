@@ -0,0 +1,243 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/heightfieldmesh.h>
+#include <modules/tnm067lab1/utils/terrainlod.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+ScalarToColorMapping testMap() {
+    ScalarToColorMapping map;
+    map.addBaseColors(vec4(0, 0, 0, 1));
+    map.addBaseColors(vec4(1, 1, 1, 1));
+    map.bake();
+    return map;
+}
+
+}  // namespace
+
+TEST(HeightfieldMeshTests, ColumnsTest) {
+    // A single column of height 1 next to a lower one: top, three border walls and the part
+    // of the shared wall above the lower column
+    const std::vector<float> values{1.0f, 0.25f};
+    const size2_t dims(2, 1);
+    const auto buffers = TNM067::HeightfieldMesh::columns(values, dims, 2.0f, testMap());
+
+    const size_t quads = 2 + 4 + 3;  // Two tops, four walls of the first, three of the second
+    ASSERT_EQ(4 * quads, buffers.vertices.size());
+    ASSERT_EQ(6 * quads, buffers.indices.size());
+    ASSERT_EQ(buffers.vertices.size(), buffers.values.size());
+
+    for (auto i : buffers.indices) EXPECT_LT(i, buffers.vertices.size());
+
+    // The top of the first column covers [0, 0.5] x [0, 1] at twice its value
+    for (size_t k = 0; k < 4; k++) {
+        const vec3 p = std::get<0>(buffers.vertices[k]);
+        EXPECT_FLOAT_EQ(2.0f, p.y);
+        EXPECT_GE(p.x, 0.0f);
+        EXPECT_LE(p.x, 0.5f);
+        EXPECT_EQ(vec3(0, 1, 0), std::get<1>(buffers.vertices[k]));
+        EXPECT_FLOAT_EQ(1.0f, buffers.values[k]);
+    }
+
+    // No part of the shared wall is below the lower column
+    for (const auto& v : buffers.vertices) {
+        const vec3 p = std::get<0>(v);
+        if (p.x == 0.5f && std::get<1>(v) == vec3(1, 0, 0)) EXPECT_GE(p.y, 0.5f);
+    }
+}
+
+TEST(HeightfieldMeshTests, GridTest) {
+    const size2_t dims(4, 3);
+    std::vector<float> values(dims.x * dims.y, 0.5f);
+    const auto buffers = TNM067::HeightfieldMesh::grid(values, dims, 1.0f, testMap());
+
+    ASSERT_EQ(dims.x * dims.y, buffers.vertices.size());
+    ASSERT_EQ(6 * (dims.x - 1) * (dims.y - 1), buffers.indices.size());
+    for (auto i : buffers.indices) EXPECT_LT(i, buffers.vertices.size());
+    for (const auto& v : buffers.vertices) {
+        EXPECT_FLOAT_EQ(0.5f, std::get<0>(v).y);
+        EXPECT_EQ(vec3(0, 1, 0), std::get<1>(v));
+    }
+}
+
+TEST(HeightfieldMeshTests, ModeCountsTest) {
+    const size2_t dims(8, 6);
+    const std::vector<float> values(dims.x * dims.y, 0.5f);
+    const auto map = testMap();
+
+    // One shared vertex per pixel and two triangles per group of 2x2 pixels
+    const auto grid = TNM067::HeightfieldMesh::grid(values, dims, 1.0f, map);
+    EXPECT_EQ(dims.x * dims.y, grid.vertices.size());
+    EXPECT_EQ(3 * 2 * (dims.x - 1) * (dims.y - 1), grid.indices.size());
+
+    // Four unshared vertices and two triangles per quad, a flat image only shows the tops and
+    // the outer walls
+    const auto columns = TNM067::HeightfieldMesh::columns(values, dims, 1.0f, map);
+    const size_t quads = dims.x * dims.y + 2 * (dims.x + dims.y);
+    EXPECT_EQ(4 * quads, columns.vertices.size());
+    EXPECT_EQ(3 * 2 * quads, columns.indices.size());
+}
+
+TEST(HeightfieldMeshTests, CullingTest) {
+    // A raised column in the middle of a plateau
+    const size2_t dims(3, 3);
+    std::vector<float> values(dims.x * dims.y, 0.5f);
+    values[4] = 1.0f;
+    const auto buffers = TNM067::HeightfieldMesh::columns(values, dims, 1.0f, testMap());
+
+    // Nine tops, the four walls of the raised column and three outer walls per side. The walls
+    // between columns of equal height and the walls facing the raised column are hidden
+    const size_t quads = 9 + 4 + 4 * 3;
+    ASSERT_EQ(4 * quads, buffers.vertices.size());
+
+    const vec2 center(1.5f / dims.x, 1.5f / dims.y);
+    for (const auto& v : buffers.vertices) {
+        const vec3 p = std::get<0>(v);
+        const vec3 n = std::get<1>(v);
+        EXPECT_NE(vec3(0, -1, 0), n) << "Bottom faces are never visible";
+        if (n.y != 0.0f) continue;
+
+        // Interior walls only rise from the plateau up to the raised column
+        const bool outer = p.x == 0.0f || p.x == 1.0f || p.z == 0.0f || p.z == 1.0f;
+        if (!outer) {
+            EXPECT_GE(p.y, 0.5f);
+            EXPECT_LE(p.y, 1.0f);
+            // And face away from the raised column
+            EXPECT_GT(glm::dot(n, vec3(p.x - center.x, 0.0f, p.z - center.y)), 0.0f);
+        }
+    }
+}
+
+// A small pseudo random terrain spread over several rows per job, the buffers have to be
+// consistent no matter how the rows are split
+TEST(HeightfieldMeshTests, TerrainTest) {
+    const size2_t dims(37, 23);
+    std::vector<float> values(dims.x * dims.y);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<float>((i * 7919) % 9973) / 9972.0f;
+    }
+    const auto map = testMap();
+
+    for (const auto& buffers : {TNM067::HeightfieldMesh::columns(values, dims, 1.0f, map),
+                                TNM067::HeightfieldMesh::grid(values, dims, 1.0f, map)}) {
+        ASSERT_EQ(buffers.vertices.size(), buffers.values.size());
+        ASSERT_EQ(0, buffers.indices.size() % 3);
+        for (auto i : buffers.indices) ASSERT_LT(i, buffers.vertices.size());
+        for (size_t i = 0; i < buffers.vertices.size(); i++) {
+            EXPECT_EQ(map.lookup(buffers.values[i]), std::get<3>(buffers.vertices[i]));
+            EXPECT_NEAR(1.0f, glm::length(std::get<1>(buffers.vertices[i])), 1e-5f);
+        }
+    }
+}
+
+TEST(HeightfieldMeshTests, ParallelTest) {
+    const size2_t dims(29, 31);
+    std::vector<float> values(dims.x * dims.y);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<float>((i * 7919) % 9973) / 9972.0f - 0.25f;
+    }
+    const auto map = testMap();
+
+    auto expectEqual = [](const TNM067::HeightfieldMesh::Buffers& serial,
+                          const TNM067::HeightfieldMesh::Buffers& parallel) {
+        ASSERT_EQ(serial.vertices.size(), parallel.vertices.size());
+        for (size_t i = 0; i < serial.vertices.size(); i++) {
+            EXPECT_EQ(std::get<0>(serial.vertices[i]), std::get<0>(parallel.vertices[i]));
+            EXPECT_EQ(std::get<1>(serial.vertices[i]), std::get<1>(parallel.vertices[i]));
+            EXPECT_EQ(std::get<3>(serial.vertices[i]), std::get<3>(parallel.vertices[i]));
+        }
+        EXPECT_EQ(serial.indices, parallel.indices);
+        EXPECT_EQ(serial.values, parallel.values);
+    };
+
+    const auto columns = TNM067::HeightfieldMesh::columns(values, dims, 1.0f, map, 1);
+    const auto grid = TNM067::HeightfieldMesh::grid(values, dims, 1.0f, map, 1);
+    for (size_t jobs : {0, 2, 7, 64}) {
+        SCOPED_TRACE("jobs " + std::to_string(jobs));
+        expectEqual(columns, TNM067::HeightfieldMesh::columns(values, dims, 1.0f, map, jobs));
+        expectEqual(grid, TNM067::HeightfieldMesh::grid(values, dims, 1.0f, map, jobs));
+    }
+}
+
+// Benchmark, not part of the unit test run. Reports how many vertices per second the column,
+// grid and adaptive builders emit for a 1024x1024 terrain, run it with
+//   --gtest_also_run_disabled_tests --gtest_filter=HeightfieldMeshTests.*Benchmark
+TEST(HeightfieldMeshTests, DISABLED_ThroughputBenchmark) {
+    const size2_t dims(1024, 1024);
+    std::vector<float> values(dims.x * dims.y);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            // Smooth hills, so the adaptive builder has both flat and detailed regions
+            values[y * dims.x + x] =
+                0.5f + 0.25f * std::sin(x * 0.02f) * std::cos(y * 0.015f) +
+                0.05f * std::sin(x * 0.2f + y * 0.1f) * (x > dims.x / 2 ? 1.0f : 0.0f);
+        }
+    }
+    const auto map = testMap();
+
+    // Millions of vertices per second, build returns the number of vertices emitted
+    auto measure = [&](auto build) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        const size_t vertices = build();
+        const std::chrono::duration<double> time =
+            std::chrono::high_resolution_clock::now() - start;
+        return static_cast<double>(vertices) / time.count() / 1.0e6;
+    };
+
+    const double columns = measure([&]() {
+        return TNM067::HeightfieldMesh::columns(values, dims, 1.0f, map).vertices.size();
+    });
+    const double grid = measure([&]() {
+        return TNM067::HeightfieldMesh::grid(values, dims, 1.0f, map).vertices.size();
+    });
+    const double adaptive =
+        measure([&]() { return TNM067::TerrainLOD::build(values, dims, 0.01f).vertices.size(); });
+
+    std::cout << "HeightfieldMesh columns: " << columns << " MVertices/s, grid: " << grid
+              << " MVertices/s, adaptive: " << adaptive << " MVertices/s" << std::endl;
+    EXPECT_GT(columns, 0.0);
+    EXPECT_GT(grid, 0.0);
+    EXPECT_GT(adaptive, 0.0);
+}
+
+}  // namespace inviwo
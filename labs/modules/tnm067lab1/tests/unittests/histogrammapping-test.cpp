@@ -0,0 +1,118 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/histogrammapping.h>
+
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace inviwo {
+
+TEST(HistogramMappingTests, HistogramTest) {
+    std::vector<glm::u8> data(100003);
+    for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<glm::u8>((i * i) % 251);
+
+    const auto hist = TNM067::HistogramMapping::histogram(data.data(), data.size(), 256);
+    std::vector<size_t> expected(256, 0);
+    for (auto v : data) expected[v]++;
+    EXPECT_EQ(expected, hist);
+
+    std::vector<float> floats = {-1.0f, 0.0f, 0.5f, 1.0f, 2.0f,
+                                 std::numeric_limits<float>::quiet_NaN()};
+    const auto floatHist = TNM067::HistogramMapping::histogram(floats.data(), floats.size(), 3);
+    EXPECT_EQ(std::vector<size_t>({2, 1, 2}), floatHist);
+}
+
+TEST(HistogramMappingTests, VectorFormatTest) {
+    // ImageMappingCPU instantiates the histogram for every layer format. Vector formats get the
+    // default number of bins and are counted by their first component
+    EXPECT_EQ(256, TNM067::HistogramMapping::binsFor<glm::u8>());
+    EXPECT_EQ(65536, TNM067::HistogramMapping::binsFor<glm::u16>());
+    EXPECT_EQ(4096, TNM067::HistogramMapping::binsFor<float>());
+    EXPECT_EQ(4096, TNM067::HistogramMapping::binsFor<glm::u8vec2>());
+
+    const std::vector<glm::u8vec2> data{glm::u8vec2(0, 7), glm::u8vec2(255, 7),
+                                        glm::u8vec2(255, 0)};
+    const auto hist = TNM067::HistogramMapping::histogram(
+        data.data(), data.size(), TNM067::HistogramMapping::binsFor<glm::u8vec2>());
+    EXPECT_EQ(1, hist.front());
+    EXPECT_EQ(2, hist.back());
+    EXPECT_EQ(3, std::accumulate(hist.begin(), hist.end(), size_t(0)));
+}
+
+TEST(HistogramMappingTests, EqualizeTest) {
+    // Everything in the lower quarter, equalization spreads it over the whole range
+    std::vector<size_t> hist(256, 0);
+    for (size_t b = 0; b < 64; b++) hist[b] = 10;
+
+    const auto transfer = TNM067::HistogramMapping::equalize(hist);
+    ASSERT_EQ(hist.size(), transfer.size());
+    EXPECT_FLOAT_EQ(0.0f, transfer[0]);
+    EXPECT_FLOAT_EQ(1.0f, transfer[63]);
+    EXPECT_NEAR(0.5f, transfer[32], 0.01f);
+    EXPECT_FLOAT_EQ(1.0f, transfer[255]);
+    for (size_t b = 1; b < transfer.size(); b++) EXPECT_LE(transfer[b - 1], transfer[b]);
+
+    // A constant image keeps the linear mapping
+    std::vector<size_t> constant(16, 0);
+    constant[5] = 100;
+    const auto flat = TNM067::HistogramMapping::equalize(constant);
+    EXPECT_FLOAT_EQ(1.0f / 3.0f, flat[5]);
+}
+
+TEST(HistogramMappingTests, PercentileClipTest) {
+    std::vector<size_t> hist(101, 1);
+    const auto transfer = TNM067::HistogramMapping::percentileClip(hist, 0.1f, 0.9f);
+    EXPECT_FLOAT_EQ(0.0f, transfer[0]);
+    EXPECT_FLOAT_EQ(0.0f, transfer[10]);
+    EXPECT_NEAR(0.5f, transfer[50], 0.02f);
+    EXPECT_FLOAT_EQ(1.0f, transfer[90]);
+    EXPECT_FLOAT_EQ(1.0f, transfer[100]);
+}
+
+TEST(HistogramMappingTests, FuseTest) {
+    ScalarToColorMapping map;
+    map.addBaseColors(vec4(0, 0, 0, 1));
+    map.addBaseColors(vec4(1, 1, 1, 1));
+
+    const std::vector<float> transfer = {1.0f, 0.0f, 0.5f};
+    const auto lut = TNM067::HistogramMapping::fuse(map, transfer);
+    ASSERT_EQ(3, lut.size());
+    EXPECT_EQ(glm::u8vec4(map.sample(1.0f) * 255.f), lut[0]);
+    EXPECT_EQ(glm::u8vec4(map.sample(0.0f) * 255.f), lut[1]);
+    EXPECT_EQ(glm::u8vec4(map.sample(0.5f) * 255.f), lut[2]);
+}
+
+}  // namespace inviwo
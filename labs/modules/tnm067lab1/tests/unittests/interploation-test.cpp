@@ -33,6 +33,7 @@
 #include <warn/pop>
 
 #include <initializer_list>
+#include <limits>
 #include <modules/tnm067lab1/utils/interpolationmethods.h>
 
 namespace inviwo {
@@ -459,4 +460,133 @@ TEST(InterpolationTests, BarycentricTest) {
 #endif
 
 
+#if ENABLE_BILINEAR_UNITTEST == 1 && ENABLE_BIQUADRATIC_UNITTEST == 1 && ENABLE_BARYCENTRIC_UNITTEST == 1
+TEST(InterpolationTests, BatchTest) {
+    const size_t n = 37;
+    std::array<std::vector<float>, 9> v;
+    std::vector<float> x(n), y(n), out(n);
+    for (size_t c = 0; c < v.size(); c++) {
+        v[c].resize(n);
+        for (size_t i = 0; i < n; i++) {
+            v[c][i] = std::fmod(0.618034f * (i * 9 + c), 1.0f);
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        x[i] = std::fmod(0.7548776f * i, 1.0f);
+        y[i] = std::fmod(0.5698403f * i, 1.0f);
+    }
+
+    TNM067::Interpolation::linear(v[0].data(), v[1].data(), x.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_FLOAT_EQ(TNM067::Interpolation::linear(v[0][i], v[1][i], x[i]), out[i]);
+    }
+
+    // Coordinates outside [0,1], including infinities, are clamped to the end points
+    const std::vector<float> outside{-std::numeric_limits<float>::infinity(), -2.0f, 3.0f,
+                                     std::numeric_limits<float>::infinity()};
+    TNM067::Interpolation::linear(v[0].data(), v[1].data(), outside.data(), out.data(), 4);
+    EXPECT_FLOAT_EQ(v[0][0], out[0]);
+    EXPECT_FLOAT_EQ(v[0][1], out[1]);
+    EXPECT_FLOAT_EQ(v[1][2], out[2]);
+    EXPECT_FLOAT_EQ(v[1][3], out[3]);
+
+    TNM067::Interpolation::quadratic(v[0].data(), v[1].data(), v[2].data(), x.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_FLOAT_EQ(TNM067::Interpolation::quadratic(v[0][i], v[1][i], v[2][i], x[i]), out[i]);
+    }
+
+    std::array<const float*, 4> v4 = {v[0].data(), v[1].data(), v[2].data(), v[3].data()};
+    TNM067::Interpolation::bilinear(v4, x.data(), y.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        std::array<float, 4> s = {v[0][i], v[1][i], v[2][i], v[3][i]};
+        EXPECT_FLOAT_EQ(TNM067::Interpolation::bilinear(s, x[i], y[i]), out[i]);
+    }
+
+    TNM067::Interpolation::barycentric(v4, x.data(), y.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        std::array<float, 4> s = {v[0][i], v[1][i], v[2][i], v[3][i]};
+        EXPECT_FLOAT_EQ(TNM067::Interpolation::barycentric(s, x[i], y[i]), out[i]);
+    }
+
+    std::array<const float*, 9> v9;
+    for (size_t c = 0; c < v.size(); c++) v9[c] = v[c].data();
+    TNM067::Interpolation::biQuadratic(v9, x.data(), y.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        std::array<float, 9> s;
+        for (size_t c = 0; c < v.size(); c++) s[c] = v[c][i];
+        EXPECT_FLOAT_EQ(TNM067::Interpolation::biQuadratic(s, x[i], y[i]), out[i]);
+    }
+}
+#endif
+
+
+TEST(InterpolationTests, KernelWeightsTest) {
+    for (auto &x : {0.0, 0.1, 0.25, 0.5, 0.7, 0.9, 1.0}) {
+        auto cr = TNM067::Interpolation::catmullRomWeights(x);
+        auto mn = TNM067::Interpolation::mitchellWeights(x);
+        auto l3 = TNM067::Interpolation::lanczos3Weights(x);
+        EXPECT_NEAR(1.0, cr[0] + cr[1] + cr[2] + cr[3], 1e-12);
+        EXPECT_NEAR(1.0, mn[0] + mn[1] + mn[2] + mn[3], 1e-12);
+        EXPECT_NEAR(1.0, l3[0] + l3[1] + l3[2] + l3[3] + l3[4] + l3[5], 1e-12);
+        // Symmetric kernels reproduce linear functions
+        EXPECT_NEAR(x, -cr[0] + cr[2] + 2 * cr[3], 1e-12);
+        EXPECT_NEAR(x, -mn[0] + mn[2] + 2 * mn[3], 1e-12);
+    }
+
+    // Catmull-Rom and Lanczos interpolate the samples, Mitchell does not
+    auto cr = TNM067::Interpolation::catmullRomWeights(0.0);
+    EXPECT_NEAR(0.0, cr[0], 1e-12);
+    EXPECT_NEAR(1.0, cr[1], 1e-12);
+    EXPECT_NEAR(0.0, cr[2], 1e-12);
+    EXPECT_NEAR(0.0, cr[3], 1e-12);
+    auto mn = TNM067::Interpolation::mitchellWeights(0.0);
+    EXPECT_NEAR(1.0 / 18.0, mn[0], 1e-12);
+    EXPECT_NEAR(16.0 / 18.0, mn[1], 1e-12);
+    auto l3 = TNM067::Interpolation::lanczos3Weights(0.0);
+    EXPECT_NEAR(1.0, l3[2], 1e-12);
+    EXPECT_NEAR(0.0, l3[0] + l3[1] + l3[3] + l3[4] + l3[5], 1e-12);
+}
+
+TEST(InterpolationTests, BiCubicTest) {
+    // Catmull-Rom reproduces a bilinear function exactly
+    auto f = [](double x, double y) { return 0.25 + 0.5 * x - 0.125 * y + 0.75 * x * y; };
+    std::array<double, 16> v;
+    for (int j = 0; j < 4; j++) {
+        for (int i = 0; i < 4; i++) {
+            v[4 * j + i] = f(i - 1, j - 1);
+        }
+    }
+    for (auto &x : {0.0, 0.3, 0.5, 0.8}) {
+        for (auto &y : {0.0, 0.2, 0.6, 1.0}) {
+            EXPECT_NEAR(f(x, y), TNM067::Interpolation::biCubic(v, x, y), 1e-12);
+        }
+        EXPECT_NEAR(f(x, 0), TNM067::Interpolation::cubic(v[4], v[5], v[6], v[7], x), 1e-12);
+    }
+}
+
+TEST(InterpolationTests, ConstexprTest) {
+    static_assert(TNM067::Interpolation::linear(0.0, 2.0, 0.25) == 0.5, "linear is constexpr");
+    static_assert(TNM067::Interpolation::linear(0.0, 2.0, 1.5) == 2.0, "linear clamps");
+    static_assert(TNM067::Interpolation::linearUnclamped(0.0, 2.0, 1.5) == 3.0, "linearUnclamped does not clamp");
+    static_assert(TNM067::Interpolation::bilinear(std::array<double, 4>{{0.0, 1.0, 2.0, 3.0}}, 0.5, 0.5) == 1.5,
+                  "bilinear is constexpr");
+
+    constexpr auto table = TNM067::Interpolation::catmullRomTable<double, 5>();
+    static_assert(table[0][1] == 1.0, "Catmull-Rom interpolates at x = 0");
+    static_assert(table[4][2] == 1.0, "Catmull-Rom interpolates at x = 1");
+    for (size_t i = 0; i < table.size(); i++) {
+        auto w = TNM067::Interpolation::catmullRomWeights(i / 4.0);
+        for (size_t k = 0; k < 4; k++) {
+            EXPECT_DOUBLE_EQ(w[k], table[i][k]);
+        }
+    }
+}
+
+TEST(InterpolationTests, BiLinearUInt8PrecisionTest) {
+    // Intermediate results are kept in double, the row values 0.5 and 254.5 are not truncated
+    std::array<std::uint8_t, 4> v = {{0, 1, 254, 255}};
+    EXPECT_EQ(127, TNM067::Interpolation::bilinear(v, 0.5, 0.5));
+    EXPECT_EQ(191, TNM067::Interpolation::bilinear(v, 0.5, 0.75));
+}
+
 }  // namespace inviwo
\ No newline at end of file
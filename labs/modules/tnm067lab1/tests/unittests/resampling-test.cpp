@@ -0,0 +1,112 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/resampling.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+using Resampler = std::function<void(const float*, size2_t, float*, size2_t)>;
+
+struct Kernel {
+    std::string name;
+    Resampler resample;
+    size_t taps;
+    float rampError;  // Lanczos-3 only approximately reproduces linear functions
+};
+
+std::vector<Kernel> kernels() {
+    return {{"Catmull-Rom", TNM067::Resampling::catmullRom<float>, 4, 1e-4f},
+            {"Mitchell", TNM067::Resampling::mitchell<float>, 4, 1e-4f},
+            {"Lanczos-3", TNM067::Resampling::lanczos3<float>, 6, 5e-2f}};
+}
+
+}  // namespace
+
+TEST(ResamplingTests, ConstantTest) {
+    const size2_t inSize(5, 4);
+    const size2_t outSize(13, 11);
+    const std::vector<float> in(inSize.x * inSize.y, 0.75f);
+    for (const auto& kernel : kernels()) {
+        SCOPED_TRACE(kernel.name);
+        std::vector<float> out(outSize.x * outSize.y);
+        kernel.resample(in.data(), inSize, out.data(), outSize);
+        for (auto v : out) EXPECT_NEAR(0.75f, v, 1e-5f);
+    }
+}
+
+TEST(ResamplingTests, RampTest) {
+    // A ramp along x, every row is the same
+    const size2_t inSize(8, 3);
+    const size2_t outSize(20, 5);
+    std::vector<float> in(inSize.x * inSize.y);
+    for (size_t i = 0; i < in.size(); i++) in[i] = 2.0f * (i % inSize.x) + 1.0f;
+
+    for (const auto& kernel : kernels()) {
+        SCOPED_TRACE(kernel.name);
+        std::vector<float> out(outSize.x * outSize.y);
+        kernel.resample(in.data(), inSize, out.data(), outSize);
+        for (size_t y = 0; y < outSize.y; y++) {
+            for (size_t x = 0; x < outSize.x; x++) {
+                // Pixel centers are aligned
+                const float c = (x + 0.5f) * inSize.x / outSize.x - 0.5f;
+                const float first = std::floor(c) - (kernel.taps / 2 - 1);
+                const float last = std::floor(c) + kernel.taps / 2;
+                const float value = out[y * outSize.x + x];
+                // Near the border the clamped samples bend the ramp
+                if (first >= 0.0f && last <= inSize.x - 1.0f) {
+                    EXPECT_NEAR(2.0f * c + 1.0f, value, kernel.rampError) << "at " << x;
+                }
+                EXPECT_NEAR(out[x], value, 1e-5f) << "at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST(ResamplingTests, UInt8Test) {
+    // The negative lobes overshoot at a step, integer output is clamped
+    const std::vector<glm::u8> in{0, 0, 255, 255};
+    std::vector<glm::u8> out(12);
+    TNM067::Resampling::catmullRom(in.data(), size2_t(4, 1), out.data(), size2_t(12, 1));
+    EXPECT_EQ(0, out.front());
+    EXPECT_EQ(255, out.back());
+    for (size_t x = 1; x < out.size(); x++) EXPECT_LE(out[x - 1], out[x]);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,78 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/scalartocolormapping.h>
+
+#include <limits>
+
+namespace inviwo {
+
+TEST(ScalarToColorMappingTests, BakedLookupTest) {
+    ScalarToColorMapping map;
+    map.addBaseColors(vec4(0, 0, 0, 1));
+    map.addBaseColors(vec4(1, 0, 0, 1));
+    map.addBaseColors(vec4(1, 1, 0, 1));
+    EXPECT_FALSE(map.isBaked());
+
+    map.bake(257);
+    ASSERT_TRUE(map.isBaked());
+    ASSERT_EQ(257, map.getLUT().size());
+    ASSERT_EQ(257, map.getLUTU8().size());
+
+    for (size_t i = 0; i < 257; i++) {
+        float t = i / 256.0f;
+        vec4 expected = map.sample(t);
+        vec4 result = map.lookup(t);
+        EXPECT_FLOAT_EQ(expected.r, result.r);
+        EXPECT_FLOAT_EQ(expected.g, result.g);
+        EXPECT_FLOAT_EQ(expected.b, result.b);
+        EXPECT_FLOAT_EQ(expected.a, result.a);
+        EXPECT_EQ(glm::u8vec4(expected * 255.f), map.lookupU8(t));
+    }
+
+    // Out of range values are clamped to the end points
+    EXPECT_EQ(map.getLUTU8().front(), map.lookupU8(-1.0f));
+    EXPECT_EQ(map.getLUTU8().back(), map.lookupU8(2.0f));
+    EXPECT_EQ(map.getLUTU8().front(), map.lookupU8(-std::numeric_limits<float>::infinity()));
+    EXPECT_EQ(map.getLUTU8().back(), map.lookupU8(std::numeric_limits<float>::infinity()));
+
+    // NaN maps to the first entry
+    EXPECT_EQ(map.getLUTU8().front(), map.lookupU8(std::numeric_limits<float>::quiet_NaN()));
+    EXPECT_EQ(map.getLUT().front(), map.lookup(std::numeric_limits<float>::quiet_NaN()));
+
+    map.addBaseColors(vec4(1, 1, 1, 1));
+    EXPECT_FALSE(map.isBaked());
+}
+
+}  // namespace inviwo
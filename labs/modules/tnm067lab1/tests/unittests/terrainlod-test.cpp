@@ -0,0 +1,136 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/terrainlod.h>
+
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+// Signed area in grid space, positive for the winding of a regular grid
+float area(const TNM067::TerrainLOD::Result& r, size_t t) {
+    const vec3 a = r.vertices[r.indices[3 * t + 0]];
+    const vec3 b = r.vertices[r.indices[3 * t + 1]];
+    const vec3 c = r.vertices[r.indices[3 * t + 2]];
+    return 0.5f * ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+}
+
+// A mesh without cracks uses every interior edge in exactly two triangles, once in each
+// direction, and every border edge once
+void expectWatertight(const TNM067::TerrainLOD::Result& r, size2_t dims) {
+    std::map<std::pair<unsigned int, unsigned int>, int> edges;
+    float total = 0.0f;
+    for (size_t t = 0; t < r.indices.size() / 3; t++) {
+        EXPECT_GT(area(r, t), 0.0f);
+        total += area(r, t);
+        for (size_t i = 0; i < 3; i++) {
+            edges[{r.indices[3 * t + i], r.indices[3 * t + (i + 1) % 3]}]++;
+        }
+    }
+    EXPECT_NEAR(float((dims.x - 1) * (dims.y - 1)), total, 1e-3f);
+
+    for (const auto& edge : edges) {
+        EXPECT_EQ(1, edge.second);
+        const bool hasTwin = edges.count({edge.first.second, edge.first.first}) > 0;
+        const vec3 a = r.vertices[edge.first.first];
+        const vec3 b = r.vertices[edge.first.second];
+        const bool onBorder = (a.x == b.x && (a.x == 0 || a.x == dims.x - 1)) ||
+                              (a.y == b.y && (a.y == 0 || a.y == dims.y - 1));
+        EXPECT_TRUE(hasTwin || onBorder) << "crack at " << a.x << "," << a.y << " - " << b.x
+                                         << "," << b.y;
+    }
+}
+
+}  // namespace
+
+TEST(TerrainLODTests, PlaneTest) {
+    const size2_t dims(33, 17);
+    std::vector<float> values(dims.x * dims.y);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) values[y * dims.x + x] = 0.01f * x + 0.02f * y;
+    }
+
+    const auto result = TNM067::TerrainLOD::build(values, dims, 1e-4f);
+    EXPECT_EQ(1, result.leafCount);
+    EXPECT_EQ(4, result.vertices.size());
+    EXPECT_EQ(6, result.indices.size());
+    expectWatertight(result, dims);
+}
+
+TEST(TerrainLODTests, FullResolutionTest) {
+    const size2_t dims(9, 6);
+    std::vector<float> values(dims.x * dims.y);
+    for (size_t i = 0; i < values.size(); i++) values[i] = static_cast<float>((i * 7) % 5);
+
+    // No error allowed, so all leaves are single cells and the mesh is the regular grid
+    const auto result = TNM067::TerrainLOD::build(values, dims, 0.0f);
+    EXPECT_EQ((dims.x - 1) * (dims.y - 1), result.leafCount);
+    EXPECT_EQ(dims.x * dims.y, result.vertices.size());
+    EXPECT_EQ(6 * (dims.x - 1) * (dims.y - 1), result.indices.size());
+    expectWatertight(result, dims);
+}
+
+TEST(TerrainLODTests, AdaptiveTest) {
+    // A single bump in an otherwise flat image, refined only around the bump
+    const size2_t dims(65, 47);
+    std::vector<float> values(dims.x * dims.y, 0.0f);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            const float dx = x - 10.0f;
+            const float dy = y - 12.0f;
+            values[y * dims.x + x] = std::exp(-(dx * dx + dy * dy) / 8.0f);
+        }
+    }
+
+    const auto result = TNM067::TerrainLOD::build(values, dims, 0.01f);
+    EXPECT_LT(result.indices.size(), 6 * (dims.x - 1) * (dims.y - 1) / 4);
+    expectWatertight(result, dims);
+
+    // The peak of the bump is kept as a vertex
+    bool found = false;
+    for (const auto& v : result.vertices) found |= (v.x == 10.0f && v.y == 12.0f);
+    EXPECT_TRUE(found);
+}
+
+TEST(TerrainLODTests, DegenerateTest) {
+    EXPECT_TRUE(TNM067::TerrainLOD::build(std::vector<float>(5, 1.0f), size2_t(5, 1), 0.0f)
+                    .indices.empty());
+}
+
+}  // namespace inviwo
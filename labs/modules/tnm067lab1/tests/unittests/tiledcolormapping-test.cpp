@@ -0,0 +1,113 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab1/utils/tiledcolormapping.h>
+#include <modules/tnm067lab1/utils/colormapkernel.h>
+#include <modules/tnm067common/tests/unittests/tempfiles.h>
+#include <inviwo/core/util/exception.h>
+
+#include <fstream>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<glm::u8vec4> readRGBA(const std::string& filename, size_t count) {
+    std::vector<glm::u8vec4> data(count);
+    std::ifstream file(filename, std::ios::binary);
+    file.read(reinterpret_cast<char*>(data.data()), count * sizeof(glm::u8vec4));
+    return data;
+}
+
+ScalarToColorMapping testMap() {
+    ScalarToColorMapping map;
+    map.addBaseColors(vec4(0, 0, 1, 1));
+    map.addBaseColors(vec4(0, 1, 0, 1));
+    map.addBaseColors(vec4(1, 0, 0, 1));
+    return map;
+}
+
+}  // namespace
+
+// 19 rows in tiles of 4 rows leaves a partial last tile
+TEST(TiledColorMappingTests, UInt16Test) {
+    const size2_t dims(37, 19);
+    std::vector<glm::u16> data(dims.x * dims.y);
+    for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<glm::u16>(i * 97);
+
+    TNM067::Testing::TempFiles files;
+    const auto in = files.writeRaw("tiledcolormapping-u16.raw", data);
+    const auto out = files.path("tiledcolormapping-u16-out.raw");
+
+    auto map = testMap();
+    TNM067::TiledColorMapping::mapRawFile(in, out, dims, DataFormatId::UInt16, map, 4);
+
+    const auto lut = TNM067::ColorMapKernel::directLUT<glm::u16>(map);
+    const auto result = readRGBA(out, data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(lut[data[i]], result[i]) << "at index " << i;
+    }
+}
+
+TEST(TiledColorMappingTests, Float32Test) {
+    const size2_t dims(53, 11);
+    std::vector<float> data(dims.x * dims.y);
+    for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<float>(i) / data.size();
+
+    TNM067::Testing::TempFiles files;
+    const auto in = files.writeRaw("tiledcolormapping-f32.raw", data);
+    const auto out = files.path("tiledcolormapping-f32-out.raw");
+
+    auto map = testMap();
+    TNM067::TiledColorMapping::mapRawFile(in, out, dims, DataFormatId::Float32, map, 3);
+
+    const auto result = readRGBA(out, data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(map.lookupU8(data[i]), result[i]) << "at index " << i;
+    }
+}
+
+TEST(TiledColorMappingTests, InputTooSmallTest) {
+    TNM067::Testing::TempFiles files;
+    const auto in = files.writeRaw("tiledcolormapping-small.raw", std::vector<glm::u8>(10));
+    const auto out = files.path("tiledcolormapping-small-out.raw");
+
+    auto map = testMap();
+    EXPECT_THROW(TNM067::TiledColorMapping::mapRawFile(in, out, size2_t(4, 4), DataFormatId::UInt8,
+                                                       map),
+                 Exception);
+}
+
+}  // namespace inviwo
@@ -32,6 +32,7 @@
 #endif
 
 #include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -41,6 +42,9 @@
 using namespace inviwo;
 
 int main(int argc, char** argv) {
+    // Provides the thread pool used by the parallel kernels under test
+    InviwoApplication app(argc, argv, "TNM067Lab1-unittests");
+
     int ret = -1;
     {
          ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,130 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab1/utils/colormapkernel.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TNM067_COLORMAP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TNM067_TARGET_AVX2
+#else
+#define TNM067_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace inviwo {
+
+namespace TNM067 {
+namespace ColorMapKernel {
+
+namespace {
+
+#if defined(TNM067_COLORMAP_X86)
+
+bool cpuHasAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // The OS has to save the ymm registers on context switches
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+TNM067_TARGET_AVX2
+void mapRowAVX2(const float* in, size_t n, const glm::u8vec4* lut, size_t lutSize,
+                glm::u8vec4* out) {
+    static_assert(sizeof(glm::u8vec4) == sizeof(int), "A color has to fit in a gather lane");
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(static_cast<float>(lutSize - 1));
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const int* table = reinterpret_cast<const int*>(lut);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 t = _mm256_loadu_ps(in + i);
+        t = _mm256_max_ps(t, zero);
+        t = _mm256_min_ps(t, one);
+        const __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(t, scale), half));
+        // Each lane gathers one packed u8vec4, so the 8 colors can be stored as they are
+        const __m256i colors = _mm256_i32gather_epi32(table, index, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), colors);
+    }
+    mapRowScalar(in + i, n - i, lut, lutSize, out + i);
+}
+
+const bool useAVX2 = cpuHasAVX2();
+
+#else
+
+const bool useAVX2 = false;
+
+#endif
+
+}  // namespace
+
+void mapRowScalar(const float* in, size_t n, const glm::u8vec4* lut, size_t lutSize,
+                  glm::u8vec4* out) {
+    const float scale = static_cast<float>(lutSize - 1);
+    for (size_t i = 0; i < n; ++i) {
+        float t = in[i];
+        t = t > 0.0f ? t : 0.0f;  // NaN ends up as 0, same as _mm256_max_ps
+        t = t < 1.0f ? t : 1.0f;
+        out[i] = lut[static_cast<size_t>(t * scale + 0.5f)];
+    }
+}
+
+void mapRow(const float* in, size_t n, const glm::u8vec4* lut, size_t lutSize, glm::u8vec4* out) {
+#if defined(TNM067_COLORMAP_X86)
+    if (useAVX2) {
+        mapRowAVX2(in, n, lut, lutSize, out);
+        return;
+    }
+#endif
+    mapRowScalar(in, n, lut, lutSize, out);
+}
+
+bool isVectorized() { return useAVX2; }
+
+}  // namespace ColorMapKernel
+}  // namespace TNM067
+
+}  // namespace inviwo
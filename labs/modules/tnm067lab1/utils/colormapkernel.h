@@ -0,0 +1,88 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_COLORMAPKERNEL_H
+#define IVW_COLORMAPKERNEL_H
+
+#include <modules/tnm067lab1/tnm067lab1moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/tnm067lab1/utils/scalartocolormapping.h>
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace inviwo {
+
+namespace TNM067 {
+namespace ColorMapKernel {
+
+/**
+ * Maps n values through a baked lookup table, see ScalarToColorMapping::getLUTU8(). Each value
+ * is clamped to [0,1] (NaN maps to 0) and looked up at index t * (lutSize - 1) + 0.5.
+ * Processes 8 pixels per iteration with AVX2 when the CPU supports it (checked once at
+ * runtime), otherwise falls back to mapRowScalar.
+ */
+IVW_MODULE_TNM067LAB1_API void mapRow(const float* in, size_t n, const glm::u8vec4* lut,
+                                      size_t lutSize, glm::u8vec4* out);
+
+/**
+ * Scalar reference implementation of mapRow
+ */
+IVW_MODULE_TNM067LAB1_API void mapRowScalar(const float* in, size_t n, const glm::u8vec4* lut,
+                                            size_t lutSize, glm::u8vec4* out);
+
+/**
+ * Table with the color of every value of an 8 or 16 bit unsigned type T, entry v is
+ * u8vec4(map.sample(v / max) * 255). Sampled exactly, so it does not have the quantization of
+ * the baked table
+ */
+template <typename T>
+std::vector<glm::u8vec4> directLUT(ScalarToColorMapping& map) {
+    static_assert(std::is_unsigned<T>::value && sizeof(T) <= 2, "Only 8 and 16 bit input");
+    const size_t size = static_cast<size_t>(std::numeric_limits<T>::max()) + 1;
+    std::vector<glm::u8vec4> lut(size);
+    for (size_t v = 0; v < size; v++) {
+        const float t = util::glm_convert_normalized<float>(static_cast<T>(v));
+        lut[v] = glm::u8vec4(map.sample(t) * 255.f);
+    }
+    return lut;
+}
+
+/**
+ * True if mapRow uses the vectorized code path
+ */
+IVW_MODULE_TNM067LAB1_API bool isVectorized();
+
+}  // namespace ColorMapKernel
+}  // namespace TNM067
+
+}  // namespace inviwo
+
+#endif  // IVW_COLORMAPKERNEL_H
@@ -0,0 +1,233 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_DOWNSAMPLING_H
+#define IVW_DOWNSAMPLING_H
+
+#include <modules/tnm067lab1/tnm067lab1moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/tnm067lab1/utils/interpolationmethods.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+namespace Downsampling {
+
+/**
+ * One level of a mip chain, pixels are stored row by row.
+ */
+template <typename T>
+struct Level {
+    size2_t size;
+    std::vector<T> data;
+};
+
+namespace detail {
+
+template <typename T, typename F>
+T fromAccumulator(F v, std::true_type) {
+    return static_cast<T>(std::round(v));
+}
+template <typename T, typename F>
+T fromAccumulator(F v, std::false_type) {
+    return static_cast<T>(v);
+}
+template <typename T, typename F>
+T fromAccumulator(F v) {
+    return fromAccumulator<T>(v, std::is_integral<T>{});
+}
+
+/**
+ * The input pixels covered by one output pixel along one axis, together with the fraction of the
+ * footprint each of them covers. The weights sum to one.
+ */
+template <typename F>
+struct Footprint {
+    size_t first;
+    std::vector<F> weights;
+};
+
+template <typename F>
+std::vector<Footprint<F>> footprints(size_t inSize, size_t outSize) {
+    std::vector<Footprint<F>> res(outSize);
+    const F scale = static_cast<F>(inSize) / static_cast<F>(outSize);
+    for (size_t o = 0; o < outSize; ++o) {
+        const F a = static_cast<F>(o) * scale;
+        const F b = std::min(static_cast<F>(inSize), static_cast<F>(o + 1) * scale);
+        const size_t first = std::min(inSize - 1, static_cast<size_t>(std::floor(a)));
+        const size_t last =
+            std::max(first + 1, std::min(inSize, static_cast<size_t>(std::ceil(b))));
+        res[o].first = first;
+        for (size_t i = first; i < last; ++i) {
+            const F w = std::min(b, static_cast<F>(i + 1)) - std::max(a, static_cast<F>(i));
+            res[o].weights.push_back(std::max(F(0), w) / (b - a));
+        }
+    }
+    return res;
+}
+
+}  // namespace detail
+
+/**
+ * Box filter reduction by a factor of two in each dimension, the output has the size
+ * max(1, inSize / 2). Every output pixel is the mean of the 2x2 input pixels it covers. When a
+ * dimension is odd the last output row/column instead covers the three remaining input
+ * rows/columns, which then weigh 1/3 each instead of 1/2, so the last input row/column is not
+ * dropped.
+ */
+template <typename T>
+void halve(const T* in, size2_t inSize, T* out) {
+    using F = typename float_type<T>::type;
+    const size2_t outSize = glm::max(size2_t(1), inSize / size_t(2));
+
+    std::vector<F> rowSum(inSize.x);
+    for (size_t y = 0; y < outSize.y; ++y) {
+        const size_t y0 = 2 * y;
+        const size_t y1 = (y + 1 == outSize.y) ? inSize.y : 2 * y + 2;
+
+        // Sum the rows of the footprint, contiguous so that it vectorizes
+        std::fill(rowSum.begin(), rowSum.end(), F(0));
+        for (size_t j = y0; j < y1; ++j) {
+            const T* row = in + j * inSize.x;
+            for (size_t x = 0; x < inSize.x; ++x) {
+                rowSum[x] += static_cast<F>(row[x]);
+            }
+        }
+
+        T* outRow = out + y * outSize.x;
+        const F pairNorm = F(1) / (F(2) * static_cast<F>(y1 - y0));
+        for (size_t x = 0; x + 1 < outSize.x; ++x) {
+            outRow[x] = detail::fromAccumulator<T>((rowSum[2 * x] + rowSum[2 * x + 1]) * pairNorm);
+        }
+
+        // Last column picks up the remainder of odd widths
+        const size_t x0 = 2 * (outSize.x - 1);
+        F sum(0);
+        for (size_t x = x0; x < inSize.x; ++x) {
+            sum += rowSum[x];
+        }
+        outRow[outSize.x - 1] = detail::fromAccumulator<T>(
+            sum / static_cast<F>((inSize.x - x0) * (y1 - y0)));
+    }
+}
+
+/**
+ * Area weighted average (box filter) resampling to an arbitrary size. Each output pixel is the
+ * mean of the input area it covers, partially covered input pixels are weighted by coverage.
+ * Evaluated separably, first along x into a temporary buffer then along y.
+ */
+template <typename T>
+void areaAverage(const T* in, size2_t inSize, T* out, size2_t outSize) {
+    using F = typename float_type<T>::type;
+    const auto fx = detail::footprints<F>(inSize.x, outSize.x);
+    const auto fy = detail::footprints<F>(inSize.y, outSize.y);
+
+    std::vector<F> tmp(outSize.x * inSize.y);
+    for (size_t y = 0; y < inSize.y; ++y) {
+        const T* row = in + y * inSize.x;
+        F* tmpRow = tmp.data() + y * outSize.x;
+        for (size_t x = 0; x < outSize.x; ++x) {
+            F sum(0);
+            for (size_t i = 0; i < fx[x].weights.size(); ++i) {
+                sum += fx[x].weights[i] * static_cast<F>(row[fx[x].first + i]);
+            }
+            tmpRow[x] = sum;
+        }
+    }
+
+    std::vector<F> rowSum(outSize.x);
+    for (size_t y = 0; y < outSize.y; ++y) {
+        std::fill(rowSum.begin(), rowSum.end(), F(0));
+        for (size_t j = 0; j < fy[y].weights.size(); ++j) {
+            const F w = fy[y].weights[j];
+            const F* tmpRow = tmp.data() + (fy[y].first + j) * outSize.x;
+            for (size_t x = 0; x < outSize.x; ++x) {
+                rowSum[x] += w * tmpRow[x];
+            }
+        }
+        T* outRow = out + y * outSize.x;
+        for (size_t x = 0; x < outSize.x; ++x) {
+            outRow[x] = detail::fromAccumulator<T>(rowSum[x]);
+        }
+    }
+}
+
+/**
+ * Builds a mip chain by repeated halving, each level computed from the previous one. Halving
+ * stops before any dimension would go below minSize. The input itself is not part of the chain.
+ * Since every level is a quarter of the previous one the total cost is linear in the input size.
+ */
+template <typename T>
+std::vector<Level<T>> mipChain(const T* in, size2_t inSize, size2_t minSize = size2_t(1)) {
+    minSize = glm::max(size2_t(1), minSize);
+    std::vector<Level<T>> levels;
+    const T* src = in;
+    size2_t size = inSize;
+    while (size.x >= 2 * minSize.x && size.y >= 2 * minSize.y) {
+        Level<T> level;
+        level.size = size / size_t(2);
+        level.data.resize(level.size.x * level.size.y);
+        halve(src, size, level.data.data());
+        levels.push_back(std::move(level));
+        src = levels.back().data.data();
+        size = levels.back().size;
+    }
+    return levels;
+}
+
+/**
+ * Anti-aliased minification to outSize. The input is halved until the next halving would
+ * undershoot outSize, and the remaining non power of two factor is handled by areaAverage.
+ * Only the two most recent levels are kept alive.
+ */
+template <typename T>
+void downsample(const T* in, size2_t inSize, T* out, size2_t outSize) {
+    std::vector<T> prev, next;
+    const T* src = in;
+    size2_t size = inSize;
+    while (size.x >= 2 * outSize.x && size.y >= 2 * outSize.y) {
+        const size2_t half = size / size_t(2);
+        next.resize(half.x * half.y);
+        halve(src, size, next.data());
+        std::swap(prev, next);
+        src = prev.data();
+        size = half;
+    }
+    areaAverage(src, size, out, outSize);
+}
+
+}  // namespace Downsampling
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_DOWNSAMPLING_H
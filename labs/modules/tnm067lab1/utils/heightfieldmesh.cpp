@@ -0,0 +1,244 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab1/utils/heightfieldmesh.h>
+#include <modules/tnm067common/utils/parallelutils.h>
+
+#include <array>
+#include <numeric>
+
+namespace inviwo {
+namespace TNM067 {
+namespace HeightfieldMesh {
+
+namespace {
+
+/**
+ * A face of a column as offsets from the column origin. Corner k is at
+ * (x + corner[k].x, upper[k] ? y1 : y0, z + corner[k].y)
+ */
+struct Face {
+    vec3 normal;
+    std::array<vec2, 4> corner;
+    std::array<bool, 4> upper;
+    ivec2 neighbour;  // The column that can cover this face
+};
+
+std::array<Face, 5> faceTemplates(vec2 cellSize) {
+    const float cx = cellSize.x;
+    const float cy = cellSize.y;
+    const std::array<bool, 4> wall{{false, false, true, true}};
+    return {{
+        // TOP, with y0 = y1 = height
+        {vec3(0, 1, 0), {{vec2(0, 0), vec2(cx, 0), vec2(cx, cy), vec2(0, cy)}}, wall, ivec2(0)},
+        // LEFT
+        {vec3(-1, 0, 0), {{vec2(0, 0), vec2(0, cy), vec2(0, cy), vec2(0, 0)}}, wall, ivec2(-1, 0)},
+        // RIGHT
+        {vec3(1, 0, 0), {{vec2(cx, 0), vec2(cx, cy), vec2(cx, cy), vec2(cx, 0)}}, wall,
+         ivec2(1, 0)},
+        // FRONT
+        {vec3(0, 0, -1), {{vec2(0, 0), vec2(cx, 0), vec2(cx, 0), vec2(0, 0)}}, wall,
+         ivec2(0, -1)},
+        // BACK
+        {vec3(0, 0, 1), {{vec2(0, cy), vec2(cx, cy), vec2(cx, cy), vec2(0, cy)}}, wall,
+         ivec2(0, 1)},
+    }};
+}
+
+// The parts [spans[i].x, spans[i].y] of the wall of a column spanning [0, h] that are not
+// covered by the neighbouring column spanning [0, neighbour]. Returns the number of spans
+inline int visibleSpans(float h, float neighbour, std::array<vec2, 2>& spans) {
+    const float lo = std::min(0.0f, h);
+    const float hi = std::max(0.0f, h);
+    const float nlo = std::min(0.0f, neighbour);
+    const float nhi = std::max(0.0f, neighbour);
+    int count = 0;
+    if (hi > nhi) spans[count++] = vec2(std::max(lo, nhi), hi);
+    if (lo < nlo) spans[count++] = vec2(lo, std::min(hi, nlo));
+    return count;
+}
+
+// Writes quads into preallocated buffers, starting at quad firstQuad
+class QuadWriter {
+public:
+    QuadWriter(Buffers& buffers, size_t firstQuad)
+        : vertex_(buffers.vertices.data() + 4 * firstQuad)
+        , index_(buffers.indices.data() + 6 * firstQuad)
+        , value_(buffers.values.data() + 4 * firstQuad)
+        , next_(static_cast<unsigned int>(4 * firstQuad)) {}
+
+    void operator()(const Face& face, float x, float z, float y0, float y1, const vec4& color,
+                    float value) {
+        for (size_t k = 0; k < 4; k++) {
+            const vec3 p(x + face.corner[k].x, face.upper[k] ? y1 : y0, z + face.corner[k].y);
+            *vertex_++ = BasicMesh::Vertex{p, face.normal, p, color};
+            *value_++ = value;
+        }
+        *index_++ = next_ + 0;
+        *index_++ = next_ + 1;
+        *index_++ = next_ + 2;
+        *index_++ = next_ + 0;
+        *index_++ = next_ + 2;
+        *index_++ = next_ + 3;
+        next_ += 4;
+    }
+
+private:
+    BasicMesh::Vertex* vertex_;
+    unsigned int* index_;
+    float* value_;
+    unsigned int next_;
+};
+
+}  // namespace
+
+Buffers columns(const std::vector<float>& values, size2_t dims, float scale,
+                const ScalarToColorMapping& map, size_t jobs) {
+    const auto faces = faceTemplates(1.0f / vec2(dims));
+    const vec2 cellSize = 1.0f / vec2(dims);
+
+    // Height of the column at (x, y), 0 outside the image
+    auto height = [&](std::ptrdiff_t x, std::ptrdiff_t y) {
+        if (x < 0 || y < 0 || x >= static_cast<std::ptrdiff_t>(dims.x) ||
+            y >= static_cast<std::ptrdiff_t>(dims.y)) {
+            return 0.0f;
+        }
+        return values[y * dims.x + x] * scale;
+    };
+
+    // Calls wall(face, y0, y1) for each visible wall segment of the column at (x, y)
+    auto forEachWall = [&](size_t x, size_t y, auto wall) {
+        const auto ix = static_cast<std::ptrdiff_t>(x);
+        const auto iy = static_cast<std::ptrdiff_t>(y);
+        const float h = height(ix, iy);
+        for (size_t f = 1; f < faces.size(); f++) {
+            std::array<vec2, 2> spans;
+            const int count = visibleSpans(
+                h, height(ix + faces[f].neighbour.x, iy + faces[f].neighbour.y), spans);
+            for (int i = 0; i < count; i++) wall(faces[f], spans[i].x, spans[i].y);
+        }
+    };
+
+    std::vector<size_t> rowOffsets(dims.y + 1, 0);
+    util::forEachRangeParallel(dims.y, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            size_t quads = dims.x;  // The tops
+            for (size_t x = 0; x < dims.x; x++) {
+                forEachWall(x, y, [&](const Face&, float, float) { quads++; });
+            }
+            rowOffsets[y + 1] = quads;
+        }
+    }, jobs);
+    std::partial_sum(rowOffsets.begin(), rowOffsets.end(), rowOffsets.begin());
+    const size_t quadCount = rowOffsets.back();
+
+    Buffers buffers;
+    buffers.vertices.resize(4 * quadCount);
+    buffers.values.resize(4 * quadCount);
+    buffers.indices.resize(6 * quadCount);
+
+    util::forEachRangeParallel(dims.y, [&](size_t begin, size_t end) {
+        QuadWriter quad(buffers, rowOffsets[begin]);
+        for (size_t y = begin; y < end; y++) {
+            const float* row = values.data() + y * dims.x;
+            const float z = y * cellSize.y;
+            for (size_t x = 0; x < dims.x; x++) {
+                const float v = row[x];
+                const float h = v * scale;
+                const vec4 color = map.lookup(v);
+                const float ox = x * cellSize.x;
+
+                quad(faces[0], ox, z, h, h, color, v);
+                forEachWall(x, y, [&](const Face& face, float y0, float y1) {
+                    quad(face, ox, z, y0, y1, color, v);
+                });
+            }
+        }
+    }, jobs);
+
+    return buffers;
+}
+
+Buffers grid(const std::vector<float>& values, size2_t dims, float scale,
+             const ScalarToColorMapping& map, size_t jobs) {
+    const vec2 cellSize = 1.0f / vec2(dims);
+    auto height = [&](size_t x, size_t y) { return values[y * dims.x + x] * scale; };
+
+    Buffers buffers;
+    buffers.vertices.resize(dims.x * dims.y);
+    buffers.values = values;
+    util::forEachRangeParallel(dims.y, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            const size_t y0 = y > 0 ? y - 1 : y;
+            const size_t y1 = y + 1 < dims.y ? y + 1 : y;
+            const float z = (y + 0.5f) * cellSize.y;
+            BasicMesh::Vertex* out = buffers.vertices.data() + y * dims.x;
+            for (size_t x = 0; x < dims.x; x++) {
+                const vec3 pos((x + 0.5f) * cellSize.x, height(x, y), z);
+
+                const size_t x0 = x > 0 ? x - 1 : x;
+                const size_t x1 = x + 1 < dims.x ? x + 1 : x;
+                const float dx =
+                    x1 > x0 ? (height(x1, y) - height(x0, y)) / ((x1 - x0) * cellSize.x) : 0.0f;
+                const float dz =
+                    y1 > y0 ? (height(x, y1) - height(x, y0)) / ((y1 - y0) * cellSize.y) : 0.0f;
+                const vec3 normal = glm::normalize(vec3(-dx, 1.0f, -dz));
+
+                out[x] = BasicMesh::Vertex{pos, normal, pos, map.lookup(values[y * dims.x + x])};
+            }
+        }
+    }, jobs);
+
+    if (dims.x > 1 && dims.y > 1) {
+        const size_t quadsPerRow = dims.x - 1;
+        buffers.indices.resize(6 * quadsPerRow * (dims.y - 1));
+        util::forEachRangeParallel(dims.y - 1, [&](size_t begin, size_t end) {
+            unsigned int* out = buffers.indices.data() + 6 * quadsPerRow * begin;
+            for (size_t y = begin; y < end; y++) {
+                for (size_t x = 0; x < quadsPerRow; x++) {
+                    const auto i0 = static_cast<unsigned int>(y * dims.x + x);
+                    const auto i2 = static_cast<unsigned int>((y + 1) * dims.x + x + 1);
+                    // Same winding as the top faces of columns
+                    *out++ = i0;
+                    *out++ = i0 + 1;
+                    *out++ = i2;
+                    *out++ = i0;
+                    *out++ = i2;
+                    *out++ = i2 - 1;
+                }
+            }
+        }, jobs);
+    }
+
+    return buffers;
+}
+
+}  // namespace HeightfieldMesh
+}  // namespace TNM067
+}  // namespace inviwo
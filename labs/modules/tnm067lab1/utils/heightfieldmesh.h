@@ -0,0 +1,82 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_HEIGHTFIELDMESH_H
+#define IVW_HEIGHTFIELDMESH_H
+
+#include <modules/tnm067lab1/tnm067lab1moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <modules/tnm067lab1/utils/scalartocolormapping.h>
+
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+namespace HeightfieldMesh {
+
+/**
+ * Vertex and triangle index buffers of a heightfield, ready for BasicMesh
+ */
+struct Buffers {
+    std::vector<BasicMesh::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<float> values;  // Input value of each vertex, for recoloring
+};
+
+/**
+ * One box per value in the grid of dims.x * dims.y values (row major), covering [0,1] in x and
+ * z with a height of value * scale. Only the visible faces are emitted: the top of every
+ * column and the parts of the side walls that rise above the neighbouring column, or above the
+ * ground at the border. The bottom faces rest on the ground and are never visible.
+ *
+ * The buffers are filled in two parallel passes over the rows. The first counts the quads of
+ * each row, a prefix sum over the rows gives where each row starts in the buffers, and the
+ * second pass writes every row straight into its own slice. The rows are split in jobs ranges,
+ * jobs = 0 lets the thread pool decide and jobs = 1 builds the mesh serially. The result does
+ * not depend on the split.
+ */
+IVW_MODULE_TNM067LAB1_API Buffers columns(const std::vector<float>& values, size2_t dims,
+                                          float scale, const ScalarToColorMapping& map,
+                                          size_t jobs = 0);
+
+/**
+ * One shared vertex per value at the pixel center, every group of 2x2 values forms two
+ * triangles. Normals are central differences, one sided at the border. Every row has a fixed
+ * number of vertices and indices, so the rows are written in parallel, split as in columns.
+ */
+IVW_MODULE_TNM067LAB1_API Buffers grid(const std::vector<float>& values, size2_t dims,
+                                       float scale, const ScalarToColorMapping& map,
+                                       size_t jobs = 0);
+
+}  // namespace HeightfieldMesh
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_HEIGHTFIELDMESH_H
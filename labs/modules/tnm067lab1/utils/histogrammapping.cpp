@@ -0,0 +1,109 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab1/utils/histogrammapping.h>
+
+#include <numeric>
+
+namespace inviwo {
+namespace TNM067 {
+namespace HistogramMapping {
+
+namespace {
+
+std::vector<float> identity(size_t bins) {
+    std::vector<float> transfer(bins);
+    const float scale = bins > 1 ? 1.0f / static_cast<float>(bins - 1) : 0.0f;
+    for (size_t b = 0; b < bins; b++) transfer[b] = static_cast<float>(b) * scale;
+    return transfer;
+}
+
+// First bin where the cumulative count reaches count
+size_t binAtCount(const std::vector<size_t>& hist, double count) {
+    double sum = 0.0;
+    for (size_t b = 0; b < hist.size(); b++) {
+        sum += static_cast<double>(hist[b]);
+        if (sum >= count && hist[b] > 0) return b;
+    }
+    return hist.size() - 1;
+}
+
+}  // namespace
+
+std::vector<float> equalize(const std::vector<size_t>& hist) {
+    const size_t total = std::accumulate(hist.begin(), hist.end(), size_t(0));
+    const auto firstOccupied =
+        std::find_if(hist.begin(), hist.end(), [](size_t count) { return count > 0; });
+    if (firstOccupied == hist.end() || *firstOccupied == total) return identity(hist.size());
+
+    const double minCdf = static_cast<double>(*firstOccupied);
+    const double range = static_cast<double>(total) - minCdf;
+    std::vector<float> transfer(hist.size());
+    size_t cdf = 0;
+    for (size_t b = 0; b < hist.size(); b++) {
+        cdf += hist[b];
+        transfer[b] = static_cast<float>(std::max(0.0, (cdf - minCdf) / range));
+    }
+    return transfer;
+}
+
+std::vector<float> percentileClip(const std::vector<size_t>& hist, float low, float high) {
+    const size_t total = std::accumulate(hist.begin(), hist.end(), size_t(0));
+    if (total == 0) return identity(hist.size());
+
+    low = std::min(std::max(low, 0.0f), 1.0f);
+    high = std::min(std::max(high, low), 1.0f);
+    const size_t lowBin = binAtCount(hist, low * static_cast<double>(total));
+    const size_t highBin = binAtCount(hist, high * static_cast<double>(total));
+
+    std::vector<float> transfer(hist.size());
+    if (highBin <= lowBin) {
+        // All values in the window fall in one bin, split at it
+        for (size_t b = 0; b < hist.size(); b++) transfer[b] = b < lowBin ? 0.0f : 1.0f;
+        return transfer;
+    }
+    const float scale = 1.0f / static_cast<float>(highBin - lowBin);
+    for (size_t b = 0; b < hist.size(); b++) {
+        const float t = (static_cast<float>(b) - static_cast<float>(lowBin)) * scale;
+        transfer[b] = std::min(std::max(t, 0.0f), 1.0f);
+    }
+    return transfer;
+}
+
+std::vector<glm::u8vec4> fuse(ScalarToColorMapping& map, const std::vector<float>& transfer) {
+    std::vector<glm::u8vec4> lut(transfer.size());
+    for (size_t b = 0; b < transfer.size(); b++) {
+        lut[b] = glm::u8vec4(map.sample(transfer[b]) * 255.f);
+    }
+    return lut;
+}
+
+}  // namespace HistogramMapping
+}  // namespace TNM067
+}  // namespace inviwo
@@ -0,0 +1,137 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_HISTOGRAMMAPPING_H
+#define IVW_HISTOGRAMMAPPING_H
+
+#include <modules/tnm067lab1/tnm067lab1moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/tnm067lab1/utils/scalartocolormapping.h>
+#include <modules/tnm067common/utils/parallelutils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+namespace HistogramMapping {
+
+namespace detail {
+
+template <typename T>
+constexpr size_t binsFor(std::true_type) {
+    return static_cast<size_t>(std::numeric_limits<T>::max()) + 1;
+}
+
+template <typename T>
+constexpr size_t binsFor(std::false_type) {
+    return 4096;
+}
+
+}  // namespace detail
+
+/**
+ * Number of histogram bins used for T, one per value for 8 and 16 bit unsigned input and the
+ * default ScalarToColorMapping::bake() resolution otherwise, including vector types
+ */
+template <typename T>
+constexpr size_t binsFor() {
+    return detail::binsFor<T>(
+        std::integral_constant<bool, std::is_unsigned<T>::value && sizeof(T) <= 2>{});
+}
+
+/**
+ * Bin of a normalized value, the same index as ColorMapKernel::mapRow uses for a table with
+ * bins entries. Values outside [0,1] are clamped.
+ */
+inline size_t binOf(float t, size_t bins) {
+    t = t > 0.0f ? t : 0.0f;
+    t = t < 1.0f ? t : 1.0f;
+    return static_cast<size_t>(t * static_cast<float>(bins - 1) + 0.5f);
+}
+
+/**
+ * Histogram of the normalized values in data, see util::glm_convert_normalized. The data is
+ * split in one chunk per pool thread, each counted into its own histogram, and the partial
+ * histograms are then added bin by bin in parallel. NaN values are not counted.
+ */
+template <typename T>
+std::vector<size_t> histogram(const T* data, size_t count, size_t bins) {
+    const size_t chunks = std::max<size_t>(std::min(util::detail::poolSize(), count), 1);
+    std::vector<std::vector<size_t>> partial(chunks, std::vector<size_t>(bins, 0));
+    util::forEachRangeParallel(chunks, [&](size_t first, size_t last) {
+        for (size_t chunk = first; chunk < last; chunk++) {
+            auto& local = partial[chunk];
+            for (size_t i = chunk * count / chunks; i < (chunk + 1) * count / chunks; i++) {
+                const float t = util::glm_convert_normalized<float>(data[i]);
+                if (std::isnan(t)) continue;
+                local[binOf(t, bins)]++;
+            }
+        }
+    }, chunks);
+    if (chunks == 1) return std::move(partial.front());
+
+    std::vector<size_t> result(bins, 0);
+    util::forEachRangeParallel(bins, [&](size_t begin, size_t end) {
+        for (const auto& local : partial) {
+            for (size_t b = begin; b < end; b++) result[b] += local[b];
+        }
+    });
+    return result;
+}
+
+/**
+ * Transfer function that equalizes the histogram: bin b maps to the fraction of values in
+ * bins up to b, shifted so the lowest occupied bin maps to 0
+ */
+IVW_MODULE_TNM067LAB1_API std::vector<float> equalize(const std::vector<size_t>& hist);
+
+/**
+ * Transfer function that maps the low percentile to 0 and the high percentile to 1 linearly,
+ * values outside are clamped. low and high are fractions in [0,1]
+ */
+IVW_MODULE_TNM067LAB1_API std::vector<float> percentileClip(const std::vector<size_t>& hist,
+                                                            float low, float high);
+
+/**
+ * Table with one entry per bin, entry b is u8vec4(map.sample(transfer[b]) * 255). It is
+ * indexed like the histogram, so it can be used directly with ColorMapKernel::mapRow, or
+ * per value for 8 and 16 bit input
+ */
+IVW_MODULE_TNM067LAB1_API std::vector<glm::u8vec4> fuse(ScalarToColorMapping& map,
+                                                        const std::vector<float>& transfer);
+
+}  // namespace HistogramMapping
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_HISTOGRAMMAPPING_H
@@ -33,6 +33,10 @@
 #include <modules/tnm067lab1/tnm067lab1moduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
 namespace inviwo {
     
     template<typename T> struct float_type{using type = double;};
@@ -46,17 +50,38 @@ namespace inviwo {
     namespace TNM067{
         namespace Interpolation{
         
+    namespace detail {
+    // Type used for intermediate results, the type T is promoted to when scaled by its float_type.
+    // double for integer and double types, float for float and T itself for the float vectors.
+    template<typename T>
+    using intermediate_t = decltype(std::declval<T>() * std::declval<typename float_type<T>::type>());
+
+    // Clamps x to [0,1], infinities go to the nearest end
+    template<typename F>
+    constexpr F clamp01(F x) {
+        return std::min(std::max(x, F(0)), F(1));
+    }
+    } // namespace detail
 
 
 #define ENABLE_LINEAR_UNITTEST 1
     template<typename T, typename F = double> 
-    T linear(const T &a, const T &b , F x){
+    constexpr T linear(const T &a, const T &b , F x){
         if(x<=0) return a;
 		if(x>=1) return b;
 
 		return (a * (1 - x) + b * x);
     }
 
+    /*
+     Linear interpolation without clamping, for callers that guarantee 0 <= x <= 1.
+     Free of branches.
+    */
+    template<typename T, typename F = double>
+    constexpr T linearUnclamped(const T &a, const T &b, F x) {
+        return static_cast<T>(a * (1 - x) + b * x);
+    }
+
 
     /*
      2------3
@@ -68,12 +93,14 @@ namespace inviwo {
     */
 #define ENABLE_BILINEAR_UNITTEST 1
     template<typename T, typename F = double> 
-    T bilinear(const std::array<T, 4> &v, F x, F y) {
+    constexpr T bilinear(const std::array<T, 4> &v, F x, F y) {
+        using I = detail::intermediate_t<T>;
+        const F tx = detail::clamp01(x);
 
-		float dx = linear(v[0], v[1], x);
-		float dy = linear(v[2], v[3], x);
+		const I dx = linearUnclamped(static_cast<I>(v[0]), static_cast<I>(v[1]), tx);
+		const I dy = linearUnclamped(static_cast<I>(v[2]), static_cast<I>(v[3]), tx);
 
-        return linear(dx, dy, y);
+        return static_cast<T>(linearUnclamped(dx, dy, detail::clamp01(y)));
     }
 
 
@@ -84,7 +111,7 @@ namespace inviwo {
     */
 #define ENABLE_QUADRATIC_UNITTEST 1
     template<typename T, typename F = double> 
-    T quadratic(const T &a, const T &b , const T &c , F x){
+    constexpr T quadratic(const T &a, const T &b , const T &c , F x){
         return (1-x)*(1-2*x) * a 
 			+ 4*x*(1-x) * b 
 			+ x*(2*x-1) * c;
@@ -106,13 +133,14 @@ namespace inviwo {
     */
 #define ENABLE_BIQUADRATIC_UNITTEST 1
     template<typename T, typename F = double> 
-    T biQuadratic(const std::array<T,9> &v ,F x,F y){
+    constexpr T biQuadratic(const std::array<T,9> &v ,F x,F y){
+        using I = detail::intermediate_t<T>;
 
-		float a = quadratic(v[0], v[1], v[2], x);
-		float b = quadratic(v[3], v[4], v[5], x);
-		float c = quadratic(v[6], v[7], v[8], x);
+		const I a = quadratic(static_cast<I>(v[0]), static_cast<I>(v[1]), static_cast<I>(v[2]), x);
+		const I b = quadratic(static_cast<I>(v[3]), static_cast<I>(v[4]), static_cast<I>(v[5]), x);
+		const I c = quadratic(static_cast<I>(v[6]), static_cast<I>(v[7]), static_cast<I>(v[8]), x);
 
-        return quadratic(a, b, c, y);
+        return static_cast<T>(quadratic(a, b, c, y));
     }
 
 
@@ -128,7 +156,7 @@ namespace inviwo {
     */
 #define ENABLE_BARYCENTRIC_UNITTEST 1
     template<typename T, typename F = double> 
-    T barycentric(const std::array<T,4> &v ,F x,F y){
+    constexpr T barycentric(const std::array<T,4> &v ,F x,F y){
 
 		// Lower triangle
 		if (x + y < 1) {
@@ -148,6 +176,174 @@ namespace inviwo {
 		}
     }
 
+
+
+    /*
+     Cubic convolution weights for the samples at -1, 0, 1 and 2 when evaluating at x in [0,1]
+     using the Mitchell-Netravali family of kernels. B = 0, C = 0.5 gives Catmull-Rom which
+     interpolates the samples, B = C = 1/3 gives the smoother Mitchell filter.
+
+     p0-----p1----p2-----p3
+     -1     0   x  1      2
+    */
+    namespace detail {
+    template<typename F>
+    constexpr F cubicInner(F d, F B, F C) {  // |d| < 1
+        return ((12 - 9 * B - 6 * C) * d * d * d + (-18 + 12 * B + 6 * C) * d * d + (6 - 2 * B)) / 6;
+    }
+    template<typename F>
+    constexpr F cubicOuter(F d, F B, F C) {  // 1 <= |d| < 2
+        return ((-B - 6 * C) * d * d * d + (6 * B + 30 * C) * d * d + (-12 * B - 48 * C) * d +
+                (8 * B + 24 * C)) / 6;
+    }
+    } // namespace detail
+
+    template<typename F>
+    constexpr std::array<F, 4> cubicWeights(F x, F B = F(0), F C = F(0.5)) {
+        return {{detail::cubicOuter(1 + x, B, C), detail::cubicInner(x, B, C),
+                 detail::cubicInner(1 - x, B, C), detail::cubicOuter(2 - x, B, C)}};
+    }
+
+    template<typename F>
+    constexpr std::array<F, 4> catmullRomWeights(F x) {
+        return cubicWeights<F>(x, F(0), F(0.5));
+    }
+
+    template<typename F>
+    constexpr std::array<F, 4> mitchellWeights(F x) {
+        return cubicWeights<F>(x, F(1) / 3, F(1) / 3);
+    }
+
+    namespace detail {
+    template<typename F, size_t... I>
+    constexpr std::array<std::array<F, 4>, sizeof...(I)> catmullRomTable(std::index_sequence<I...>) {
+        return {{catmullRomWeights(static_cast<F>(I) / static_cast<F>(sizeof...(I) - 1))...}};
+    }
+    template<typename F, size_t... I>
+    constexpr std::array<std::array<F, 4>, sizeof...(I)> mitchellTable(std::index_sequence<I...>) {
+        return {{mitchellWeights(static_cast<F>(I) / static_cast<F>(sizeof...(I) - 1))...}};
+    }
+    } // namespace detail
+
+    /*
+     Weight tables with N evenly spaced entries over x in [0,1], entry i holds the weights for
+     x = i / (N - 1). Usable in constant expressions, so they can be generated at compile time:
+     constexpr auto table = catmullRomTable<float, 256>();
+    */
+    template<typename F, size_t N>
+    constexpr std::array<std::array<F, 4>, N> catmullRomTable() {
+        return detail::catmullRomTable<F>(std::make_index_sequence<N>{});
+    }
+    template<typename F, size_t N>
+    constexpr std::array<std::array<F, 4>, N> mitchellTable() {
+        return detail::mitchellTable<F>(std::make_index_sequence<N>{});
+    }
+
+    /*
+     Lanczos-3 weights for the samples at -2, -1, 0, 1, 2 and 3 when evaluating at x in [0,1].
+     The weights are normalized to sum to one.
+    */
+    template<typename F>
+    std::array<F, 6> lanczos3Weights(F x) {
+        const F pi = F(3.14159265358979323846);
+        auto sinc = [&](F d) { return d == 0 ? F(1) : std::sin(pi * d) / (pi * d); };
+        std::array<F, 6> w;
+        F sum(0);
+        for (int i = 0; i < 6; ++i) {
+            const F d = x - static_cast<F>(i - 2);
+            w[i] = sinc(d) * sinc(d / 3);
+            sum += w[i];
+        }
+        for (auto &v : w) v /= sum;
+        return w;
+    }
+
+    /*
+     Catmull-Rom interpolation between p1 and p2
+    */
+    template<typename T, typename F = double>
+    constexpr T cubic(const T &p0, const T &p1, const T &p2, const T &p3, F x) {
+        const auto w = catmullRomWeights(x);
+        return static_cast<T>(w[0] * p0 + w[1] * p1 + w[2] * p2 + w[3] * p3);
+    }
+
+    /*
+     Catmull-Rom interpolation of a 4x4 neighbourhood stored row by row from (-1,-1).
+     Evaluated separably with one set of weights per axis.
+
+    12---13---14---15
+    |    |    |    |
+    8----9----10---11
+    |    |    |    |
+    4----5----6----7
+    |    |  |    |
+    0----1----2----3
+    */
+    template<typename T, typename F = double>
+    constexpr T biCubic(const std::array<T, 16> &v, F x, F y) {
+        using I = detail::intermediate_t<T>;
+        const auto wx = catmullRomWeights(x);
+        const auto wy = catmullRomWeights(y);
+        I res(0);
+        for (size_t j = 0; j < 4; ++j) {
+            const I row = wx[0] * static_cast<I>(v[4 * j]) + wx[1] * static_cast<I>(v[4 * j + 1]) +
+                          wx[2] * static_cast<I>(v[4 * j + 2]) + wx[3] * static_cast<I>(v[4 * j + 3]);
+            res += wy[j] * row;
+        }
+        return static_cast<T>(res);
+    }
+
+    /*
+     Batch evaluation
+     The overloads below evaluate n samples at once from structure of arrays input: every
+     corner value and the x/y coordinates are separate arrays where element i belongs to
+     sample i. They are plain loops over the scalar functions without explicit SIMD, any
+     vectorization is left to the compiler.
+    */
+    template<typename T, typename F = double>
+    void linear(const T *a, const T *b, const F *x, T *out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = linearUnclamped(a[i], b[i], detail::clamp01(x[i]));
+        }
+    }
+
+    template<typename T, typename F = double>
+    void bilinear(const std::array<const T*, 4> &v, const F *x, const F *y, T *out, size_t n) {
+        const T *v0 = v[0], *v1 = v[1], *v2 = v[2], *v3 = v[3];
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = bilinear(std::array<T, 4>{{v0[i], v1[i], v2[i], v3[i]}}, x[i], y[i]);
+        }
+    }
+
+    template<typename T, typename F = double>
+    void quadratic(const T *a, const T *b, const T *c, const F *x, T *out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = quadratic(a[i], b[i], c[i], x[i]);
+        }
+    }
+
+    template<typename T, typename F = double>
+    void biQuadratic(const std::array<const T*, 9> &v, const F *x, const F *y, T *out, size_t n) {
+        const T *v0 = v[0], *v1 = v[1], *v2 = v[2], *v3 = v[3], *v4 = v[4], *v5 = v[5], *v6 = v[6],
+                *v7 = v[7], *v8 = v[8];
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = biQuadratic(std::array<T, 9>{{v0[i], v1[i], v2[i], v3[i], v4[i], v5[i], v6[i], v7[i], v8[i]}},
+                                 x[i], y[i]);
+        }
+    }
+
+    template<typename T, typename F = double>
+    void barycentric(const std::array<const T*, 4> &v, const F *x, const F *y, T *out, size_t n) {
+        const T *v0 = v[0], *v1 = v[1], *v2 = v[2], *v3 = v[3];
+        for (size_t i = 0; i < n; ++i) {
+            // Evaluate both triangles and pick one with a 0/1 mask
+            const F upperMask = static_cast<F>(x[i] + y[i] >= 1);
+            const T lower = (1 - x[i] - y[i]) * v0[i] + x[i] * v1[i] + y[i] * v2[i];
+            const T upper = (x[i] + y[i] - 1) * v3[i] + (1 - y[i]) * v1[i] + (1 - x[i]) * v2[i];
+            out[i] = lower * (1 - upperMask) + upper * upperMask;
+        }
+    }
+
 } // namespace interpolation
 } // namespace TNM067
 } // namespace inviwo
@@ -0,0 +1,164 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_RESAMPLING_H
+#define IVW_RESAMPLING_H
+
+#include <modules/tnm067lab1/tnm067lab1moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/tnm067lab1/utils/interpolationmethods.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+namespace Resampling {
+
+namespace detail {
+
+template <typename T, typename F>
+T toOutput(F v, std::true_type) {
+    v = std::round(v);
+    v = std::min(std::max(v, static_cast<F>(std::numeric_limits<T>::lowest())),
+                 static_cast<F>(std::numeric_limits<T>::max()));
+    return static_cast<T>(v);
+}
+template <typename T, typename F>
+T toOutput(F v, std::false_type) {
+    return static_cast<T>(v);
+}
+
+// Input taps and weights used by one output column (or row)
+template <typename F, size_t N>
+struct Taps {
+    std::array<size_t, N> index;
+    std::array<F, N> weight;
+};
+
+/**
+ * The taps of every output position along an axis of outSize pixels over inSize input pixels.
+ * Pixel centers are aligned, output pixel o samples the input at c = (o + 0.5) * inSize /
+ * outSize - 0.5. The kernel returns the N weights for the samples floor(c)-(N/2-1) ...
+ * floor(c)+N/2 given the fractional part of c, samples outside the input are clamped to the
+ * border.
+ */
+template <typename F, size_t N, typename Kernel>
+std::vector<Taps<F, N>> weightTable(size_t inSize, size_t outSize, Kernel kernel) {
+    std::vector<Taps<F, N>> table(outSize);
+    const double scale = static_cast<double>(inSize) / static_cast<double>(outSize);
+    for (size_t o = 0; o < outSize; ++o) {
+        const double c = (static_cast<double>(o) + 0.5) * scale - 0.5;
+        const double base = std::floor(c);
+        const auto w = kernel(static_cast<F>(c - base));
+        const auto first =
+            static_cast<std::ptrdiff_t>(base) - static_cast<std::ptrdiff_t>(N / 2 - 1);
+        for (size_t k = 0; k < N; ++k) {
+            const auto idx = first + static_cast<std::ptrdiff_t>(k);
+            table[o].index[k] = static_cast<size_t>(
+                glm::clamp<std::ptrdiff_t>(idx, 0, static_cast<std::ptrdiff_t>(inSize) - 1));
+            table[o].weight[k] = w[k];
+        }
+    }
+    return table;
+}
+
+}  // namespace detail
+
+/**
+ * Separable convolution resampling with an N tap kernel, see detail::weightTable for how the
+ * output pixels map to the input. The weights only depend on the output column or row, so they
+ * are computed once per axis and shared by all rows/columns. The image is filtered along x into
+ * a temporary buffer and then along y, which costs 2N multiply-adds per output pixel instead of
+ * N*N. Cubic and Lanczos kernels have negative lobes, integer output is rounded and clamped.
+ */
+template <size_t N, typename T, typename Kernel>
+void separable(const T* in, size2_t inSize, T* out, size2_t outSize, Kernel kernel) {
+    using F = typename float_type<T>::type;
+    const auto xTaps = detail::weightTable<F, N>(inSize.x, outSize.x, kernel);
+    const auto yTaps = detail::weightTable<F, N>(inSize.y, outSize.y, kernel);
+
+    std::vector<F> tmp(outSize.x * inSize.y);
+    for (size_t y = 0; y < inSize.y; ++y) {
+        const T* inRow = in + y * inSize.x;
+        F* tmpRow = tmp.data() + y * outSize.x;
+        for (size_t x = 0; x < outSize.x; ++x) {
+            F sum(0);
+            for (size_t k = 0; k < N; ++k) {
+                sum += xTaps[x].weight[k] * static_cast<F>(inRow[xTaps[x].index[k]]);
+            }
+            tmpRow[x] = sum;
+        }
+    }
+
+    std::vector<F> rowSum(outSize.x);
+    for (size_t y = 0; y < outSize.y; ++y) {
+        std::fill(rowSum.begin(), rowSum.end(), F(0));
+        for (size_t k = 0; k < N; ++k) {
+            const F w = yTaps[y].weight[k];
+            const F* tmpRow = tmp.data() + yTaps[y].index[k] * outSize.x;
+            for (size_t x = 0; x < outSize.x; ++x) {
+                rowSum[x] += w * tmpRow[x];
+            }
+        }
+        T* outRow = out + y * outSize.x;
+        for (size_t x = 0; x < outSize.x; ++x) {
+            outRow[x] = detail::toOutput<T>(rowSum[x], std::is_integral<T>{});
+        }
+    }
+}
+
+template <typename T>
+void catmullRom(const T* in, size2_t inSize, T* out, size2_t outSize) {
+    using F = typename float_type<T>::type;
+    separable<4>(in, inSize, out, outSize,
+                 [](F x) { return Interpolation::catmullRomWeights(x); });
+}
+
+template <typename T>
+void mitchell(const T* in, size2_t inSize, T* out, size2_t outSize) {
+    using F = typename float_type<T>::type;
+    separable<4>(in, inSize, out, outSize, [](F x) { return Interpolation::mitchellWeights(x); });
+}
+
+template <typename T>
+void lanczos3(const T* in, size2_t inSize, T* out, size2_t outSize) {
+    using F = typename float_type<T>::type;
+    separable<6>(in, inSize, out, outSize, [](F x) { return Interpolation::lanczos3Weights(x); });
+}
+
+}  // namespace Resampling
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_RESAMPLING_H
@@ -39,9 +39,28 @@ ScalarToColorMapping::ScalarToColorMapping() {}
 
 ScalarToColorMapping::~ScalarToColorMapping() {}
 
-void ScalarToColorMapping::clearColors() { baseColors_.clear(); }
+void ScalarToColorMapping::clearColors() {
+    baseColors_.clear();
+    lut_.clear();
+    lutU8_.clear();
+}
+
+void ScalarToColorMapping::addBaseColors(vec4 color) {
+    baseColors_.push_back(color);
+    lut_.clear();
+    lutU8_.clear();
+}
 
-void ScalarToColorMapping::addBaseColors(vec4 color) { baseColors_.push_back(color); }
+void ScalarToColorMapping::bake(size_t resolution) {
+    resolution = std::max<size_t>(resolution, 2);
+    lut_.resize(resolution);
+    lutU8_.resize(resolution);
+    lutScale_ = static_cast<float>(resolution - 1);
+    for (size_t i = 0; i < resolution; i++) {
+        lut_[i] = sample(static_cast<float>(i) / lutScale_);
+        lutU8_[i] = glm::u8vec4(lut_[i] * 255.f);
+    }
+}
 
 vec4 ScalarToColorMapping::sample(float t) {
     if (baseColors_.size() == 0) return vec4(t);
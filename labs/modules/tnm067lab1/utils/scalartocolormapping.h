@@ -44,6 +44,10 @@ namespace inviwo {
  * \brief Scalar to color mapping
  * Color are interpolated from the baseColors_ and stored
  * in interpolatedColors_
+ *
+ * The mapping can be baked into a lookup table with bake(), after which lookup() and
+ * lookupU8() map a scalar with a single multiply and index. Changing the base colors
+ * discards the table.
  */
 class IVW_MODULE_TNM067LAB1_API ScalarToColorMapping {
 public:
@@ -53,8 +57,37 @@ public:
     void clearColors();
     vec4 sample(float t);
 
+    /**
+     * Bakes the mapping into a table of resolution entries, entry i is sample(i / (resolution-1))
+     */
+    void bake(size_t resolution = 4096);
+    bool isBaked() const { return !lut_.empty(); }
+
+    /**
+     * Nearest entry of the baked table, t is clamped to [0,1] and NaN gives the first entry.
+     * Requires bake()
+     */
+    vec4 lookup(float t) const { return lut_[lutIndex(t)]; }
+    /**
+     * Same as lookup() but in 8 bit per channel, i.e. u8vec4(sample(t) * 255)
+     */
+    glm::u8vec4 lookupU8(float t) const { return lutU8_[lutIndex(t)]; }
+
+    const std::vector<vec4>& getLUT() const { return lut_; }
+    const std::vector<glm::u8vec4>& getLUTU8() const { return lutU8_; }
+
 private:
+    // NaN goes to the first entry, the same as ColorMapKernel::mapRow
+    size_t lutIndex(float t) const {
+        t = t > 0.0f ? t : 0.0f;
+        t = t < 1.0f ? t : 1.0f;
+        return static_cast<size_t>(t * lutScale_ + 0.5f);
+    }
+
     std::vector<vec4> baseColors_;  // base colors to be interpolated
+    std::vector<vec4> lut_;
+    std::vector<glm::u8vec4> lutU8_;
+    float lutScale_ = 0.0f;  // lut_.size() - 1
 };
 
 }  // namespace inviwo
@@ -0,0 +1,159 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab1/utils/terrainlod.h>
+
+#include <cmath>
+
+namespace inviwo {
+namespace TNM067 {
+namespace TerrainLOD {
+
+namespace {
+
+// Grid points [x0, x1] x [y0, y1], inclusive
+struct Node {
+    size_t x0, y0, x1, y1;
+};
+
+class Builder {
+public:
+    Builder(const std::vector<float>& values, size2_t dims, float maxError)
+        : values_(values), dims_(dims), maxError_(maxError) {}
+
+    Result build() {
+        Result result;
+        if (dims_.x < 2 || dims_.y < 2) return result;
+
+        subdivide(Node{0, 0, dims_.x - 1, dims_.y - 1});
+
+        // Every leaf corner becomes a vertex
+        const unsigned int unused = ~0u;
+        vertexIndex_.assign(dims_.x * dims_.y, unused);
+        for (const auto& leaf : leaves_) {
+            for (auto p : {size2_t(leaf.x0, leaf.y0), size2_t(leaf.x1, leaf.y0),
+                           size2_t(leaf.x1, leaf.y1), size2_t(leaf.x0, leaf.y1)}) {
+                auto& index = vertexIndex_[p.y * dims_.x + p.x];
+                if (index == unused) {
+                    index = static_cast<unsigned int>(result.vertices.size());
+                    result.vertices.emplace_back(p.x, p.y, value(p.x, p.y));
+                }
+            }
+        }
+
+        std::vector<unsigned int> ring;
+        for (const auto& leaf : leaves_) {
+            ring.clear();
+            auto add = [&](size_t x, size_t y) {
+                const auto index = vertexIndex_[y * dims_.x + x];
+                if (index != unused) ring.push_back(index);
+            };
+            // Counter clockwise in grid space, starting at (x0, y0)
+            for (size_t x = leaf.x0; x < leaf.x1; x++) add(x, leaf.y0);
+            for (size_t y = leaf.y0; y < leaf.y1; y++) add(leaf.x1, y);
+            for (size_t x = leaf.x1; x > leaf.x0; x--) add(x, leaf.y1);
+            for (size_t y = leaf.y1; y > leaf.y0; y--) add(leaf.x0, y);
+
+            if (ring.size() == 4) {
+                result.indices.insert(result.indices.end(),
+                                      {ring[0], ring[1], ring[2], ring[0], ring[2], ring[3]});
+            } else {
+                const auto center = static_cast<unsigned int>(result.vertices.size());
+                const float v = 0.25f * (value(leaf.x0, leaf.y0) + value(leaf.x1, leaf.y0) +
+                                         value(leaf.x1, leaf.y1) + value(leaf.x0, leaf.y1));
+                result.vertices.emplace_back(0.5f * (leaf.x0 + leaf.x1), 0.5f * (leaf.y0 + leaf.y1),
+                                             v);
+                for (size_t i = 0; i < ring.size(); i++) {
+                    result.indices.insert(result.indices.end(),
+                                          {center, ring[i], ring[(i + 1) % ring.size()]});
+                }
+            }
+        }
+        result.leafCount = leaves_.size();
+        return result;
+    }
+
+private:
+    float value(size_t x, size_t y) const { return values_[y * dims_.x + x]; }
+
+    // Largest difference between the values in the node and the bilinear interpolation of its
+    // corners
+    float error(const Node& n) const {
+        const float v00 = value(n.x0, n.y0);
+        const float v10 = value(n.x1, n.y0);
+        const float v01 = value(n.x0, n.y1);
+        const float v11 = value(n.x1, n.y1);
+        const float sx = 1.0f / static_cast<float>(n.x1 - n.x0);
+        const float sy = 1.0f / static_cast<float>(n.y1 - n.y0);
+        float maxError = 0.0f;
+        for (size_t y = n.y0; y <= n.y1; y++) {
+            const float ty = (y - n.y0) * sy;
+            const float left = v00 + (v01 - v00) * ty;
+            const float right = v10 + (v11 - v10) * ty;
+            for (size_t x = n.x0; x <= n.x1; x++) {
+                const float tx = (x - n.x0) * sx;
+                const float interpolated = left + (right - left) * tx;
+                maxError = std::max(maxError, std::abs(value(x, y) - interpolated));
+            }
+            if (maxError > maxError_) return maxError;
+        }
+        return maxError;
+    }
+
+    void subdivide(const Node& n) {
+        const bool splitX = n.x1 - n.x0 > 1;
+        const bool splitY = n.y1 - n.y0 > 1;
+        if ((!splitX && !splitY) || error(n) <= maxError_) {
+            leaves_.push_back(n);
+            return;
+        }
+        const size_t xm = splitX ? (n.x0 + n.x1) / 2 : n.x1;
+        const size_t ym = splitY ? (n.y0 + n.y1) / 2 : n.y1;
+        subdivide(Node{n.x0, n.y0, xm, ym});
+        if (splitX) subdivide(Node{xm, n.y0, n.x1, ym});
+        if (splitY) subdivide(Node{n.x0, ym, xm, n.y1});
+        if (splitX && splitY) subdivide(Node{xm, ym, n.x1, n.y1});
+    }
+
+    const std::vector<float>& values_;
+    const size2_t dims_;
+    const float maxError_;
+    std::vector<Node> leaves_;
+    std::vector<unsigned int> vertexIndex_;
+};
+
+}  // namespace
+
+Result build(const std::vector<float>& values, size2_t dims, float maxError) {
+    return Builder(values, dims, maxError).build();
+}
+
+}  // namespace TerrainLOD
+}  // namespace TNM067
+}  // namespace inviwo
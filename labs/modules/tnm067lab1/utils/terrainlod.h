@@ -0,0 +1,70 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_TERRAINLOD_H
+#define IVW_TERRAINLOD_H
+
+#include <modules/tnm067lab1/tnm067lab1moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+namespace TerrainLOD {
+
+/**
+ * An adaptive triangulation of a height grid. Vertices are in grid coordinates, x and y are
+ * the column and row of the grid point and z is the value there.
+ */
+struct Result {
+    std::vector<vec3> vertices;
+    std::vector<unsigned int> indices;  // Triangles, same winding as a regular grid
+    size_t leafCount = 0;
+};
+
+/**
+ * Triangulates the grid of dims.x * dims.y values (row major) with an error quadtree. A node is
+ * split as long as some grid point inside it deviates more than maxError from the bilinear
+ * interpolation of the node's corners and the node is larger than one cell, so flat and planar
+ * regions end up as large patches.
+ *
+ * Every leaf is triangulated with all leaf corners that lie on its border. A leaf whose border
+ * holds more than its own four corners gets an extra vertex in its center and a triangle fan,
+ * so neighbouring leaves of different size share the same vertices along their common edge and
+ * the mesh has no cracks.
+ */
+IVW_MODULE_TNM067LAB1_API Result build(const std::vector<float>& values, size2_t dims,
+                                       float maxError);
+
+}  // namespace TerrainLOD
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_TERRAINLOD_H
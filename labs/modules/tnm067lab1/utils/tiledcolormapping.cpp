@@ -0,0 +1,166 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab1/utils/tiledcolormapping.h>
+#include <modules/tnm067lab1/utils/colormapkernel.h>
+#include <modules/tnm067common/utils/mappedfile.h>
+#include <modules/tnm067common/utils/parallelutils.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <type_traits>
+#include <vector>
+
+namespace inviwo {
+
+namespace TNM067 {
+namespace TiledColorMapping {
+
+namespace detail {
+
+void mapTile(const float* in, size_t width, size_t rows, glm::u8vec4* out,
+             const std::vector<glm::u8vec4>& lut) {
+    util::forEachRangeParallel(rows, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            ColorMapKernel::mapRow(in + y * width, width, lut.data(), lut.size(), out + y * width);
+        }
+    });
+}
+
+template <typename T>
+void mapTile(const T* in, size_t width, size_t rows, glm::u8vec4* out,
+             const std::vector<glm::u8vec4>& lut) {
+    const glm::u8vec4* table = lut.data();
+    util::forEachRangeParallel(rows, [&](size_t begin, size_t end) {
+        for (size_t i = begin * width; i < end * width; i++) {
+            out[i] = table[in[i]];
+        }
+    });
+}
+
+template <typename T>
+std::vector<glm::u8vec4> tableFor(ScalarToColorMapping& map, std::true_type) {
+    if (!map.isBaked()) map.bake();
+    return map.getLUTU8();
+}
+
+template <typename T>
+std::vector<glm::u8vec4> tableFor(ScalarToColorMapping& map, std::false_type) {
+    return ColorMapKernel::directLUT<T>(map);
+}
+
+template <typename T>
+void mapFile(const MappedFile& input, MappedFile& output, size2_t dims, ScalarToColorMapping& map,
+             size_t tileRows) {
+    const size_t width = dims.x;
+    const size_t tileCount = (dims.y + tileRows - 1) / tileRows;
+    const auto lut = tableFor<T>(map, std::is_floating_point<T>{});
+
+    const T* in = reinterpret_cast<const T*>(input.data());
+    glm::u8vec4* out = reinterpret_cast<glm::u8vec4*>(output.data());
+
+    auto rowsOf = [&](size_t tile) { return std::min(tileRows, dims.y - tile * tileRows); };
+
+    // Reading the mapped input is what triggers the disk I/O, so it is done into a separate
+    // buffer on its own thread while the previous tile is being mapped
+    std::array<std::vector<T>, 2> buffers;
+    for (auto& buffer : buffers) buffer.resize(tileRows * width);
+    auto load = [&](size_t tile) {
+        const size_t first = tile * tileRows * width;
+        const size_t count = rowsOf(tile) * width;
+        input.prefetch(first * sizeof(T), count * sizeof(T));
+        std::copy(in + first, in + first + count, buffers[tile % 2].begin());
+        input.release(first * sizeof(T), count * sizeof(T));
+    };
+
+    load(0);
+    for (size_t tile = 0; tile < tileCount; tile++) {
+        std::future<void> next;
+        if (tile + 1 < tileCount) {
+            next = std::async(std::launch::async, load, tile + 1);
+        }
+
+        const size_t first = tile * tileRows * width;
+        const size_t count = rowsOf(tile) * width;
+        mapTile(buffers[tile % 2].data(), width, rowsOf(tile), out + first, lut);
+        output.flush(first * sizeof(glm::u8vec4), count * sizeof(glm::u8vec4));
+        output.release(first * sizeof(glm::u8vec4), count * sizeof(glm::u8vec4));
+
+        if (next.valid()) next.get();
+    }
+}
+
+}  // namespace detail
+
+void mapRawFile(const std::string& inputFile, const std::string& outputFile, size2_t dims,
+                DataFormatId format, ScalarToColorMapping& map, size_t tileRows) {
+    size_t bytesPerValue = 0;
+    switch (format) {
+        case DataFormatId::UInt8:
+            bytesPerValue = 1;
+            break;
+        case DataFormatId::UInt16:
+            bytesPerValue = 2;
+            break;
+        case DataFormatId::Float32:
+            bytesPerValue = 4;
+            break;
+        default:
+            throw Exception("Only UInt8, UInt16 and Float32 input is supported",
+                            IvwContextCustom("TiledColorMapping"));
+    }
+    if (dims.x == 0 || dims.y == 0) return;
+    tileRows = std::max(tileRows, size_t(1));
+
+    const auto input = MappedFile::openRead(inputFile);
+    if (input.size() < dims.x * dims.y * bytesPerValue) {
+        throw Exception(inputFile + " is smaller than the given dimensions and format",
+                        IvwContextCustom("TiledColorMapping"));
+    }
+    auto output = MappedFile::create(outputFile, dims.x * dims.y * sizeof(glm::u8vec4));
+
+    switch (format) {
+        case DataFormatId::UInt8:
+            detail::mapFile<glm::u8>(input, output, dims, map, tileRows);
+            break;
+        case DataFormatId::UInt16:
+            detail::mapFile<glm::u16>(input, output, dims, map, tileRows);
+            break;
+        default:
+            detail::mapFile<float>(input, output, dims, map, tileRows);
+            break;
+    }
+}
+
+}  // namespace TiledColorMapping
+}  // namespace TNM067
+
+}  // namespace inviwo
@@ -0,0 +1,68 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_TILEDCOLORMAPPING_H
+#define IVW_TILEDCOLORMAPPING_H
+
+#include <modules/tnm067lab1/tnm067lab1moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/formats.h>
+#include <modules/tnm067lab1/utils/scalartocolormapping.h>
+
+#include <string>
+
+namespace inviwo {
+
+namespace TNM067 {
+namespace TiledColorMapping {
+
+/**
+ * Colormaps a raw single channel image that is too large to keep in memory. inputFile holds
+ * dims.x * dims.y values of the given format (UInt8, UInt16 or Float32, row major, native byte
+ * order) and outputFile is written as a raw RGBA8 image of the same dimensions.
+ *
+ * Both files are memory mapped and processed tileRows rows at a time. While one tile is mapped
+ * on the thread pool the next one is read into a second buffer on a separate thread, and
+ * finished tiles are flushed and dropped from memory, so only a few tiles are resident at any
+ * time. The colors are the same as in ImageMappingCPU: 8 and 16 bit input goes through
+ * ColorMapKernel::directLUT and float input through the baked table of map.
+ * Throws an Exception if a file can not be mapped, the input is too small or the format is not
+ * supported.
+ */
+IVW_MODULE_TNM067LAB1_API void mapRawFile(const std::string& inputFile,
+                                          const std::string& outputFile, size2_t dims,
+                                          DataFormatId format, ScalarToColorMapping& map,
+                                          size_t tileRows = 256);
+
+}  // namespace TiledColorMapping
+}  // namespace TNM067
+
+}  // namespace inviwo
+
+#endif  // IVW_TILEDCOLORMAPPING_H
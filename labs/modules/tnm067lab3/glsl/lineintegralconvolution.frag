@@ -32,9 +32,75 @@ uniform sampler2D noiseColor;
 
 uniform int steps;
 uniform float stepSize;
+uniform int integrator;  // 0 Euler, 1 RK2, 2 RK4, 3 RK45, same as TNM067::LIC::Integrator
+uniform float tolerance; // RK45 only, largest accepted error per unit of streamline length
 
 in vec3 texCoord_;
 
+vec2 direction(vec2 pos){
+    vec2 v = texture(vfColor, pos).rg;
+    float l = length(v);
+    return l > 0.0 ? v / l : vec2(0.0);
+}
+
+// Cash-Karp step, returns the fifth order solution and the difference to the fourth order one
+vec2 cashKarp(vec2 pos, float h, out vec2 error){
+    vec2 k1 = direction(pos);
+    vec2 k2 = direction(pos + h * (1.0 / 5.0) * k1);
+    vec2 k3 = direction(pos + h * ((3.0 / 40.0) * k1 + (9.0 / 40.0) * k2));
+    vec2 k4 = direction(pos + h * ((3.0 / 10.0) * k1 - (9.0 / 10.0) * k2 + (6.0 / 5.0) * k3));
+    vec2 k5 = direction(pos + h * ((-11.0 / 54.0) * k1 + (5.0 / 2.0) * k2
+                                   - (70.0 / 27.0) * k3 + (35.0 / 27.0) * k4));
+    vec2 k6 = direction(pos + h * ((1631.0 / 55296.0) * k1 + (175.0 / 512.0) * k2
+                                   + (575.0 / 13824.0) * k3 + (44275.0 / 110592.0) * k4
+                                   + (253.0 / 4096.0) * k5));
+    vec2 fifth = (37.0 / 378.0) * k1 + (250.0 / 621.0) * k3 + (125.0 / 594.0) * k4
+               + (512.0 / 1771.0) * k6;
+    vec2 fourth = (2825.0 / 27648.0) * k1 + (18575.0 / 48384.0) * k3
+                + (13525.0 / 55296.0) * k4 + (277.0 / 14336.0) * k5 + (1.0 / 4.0) * k6;
+    error = h * (fifth - fourth);
+    return pos + h * fifth;
+}
+
+// Advances pos by h in sub steps that are shrunk until their error is within the tolerance
+// times their length, as adaptiveStep in lic.cpp
+vec2 adaptiveStep(vec2 pos, float h){
+    float tol = max(tolerance, 1e-7);
+    float remaining = h;
+    float sub = h;
+    for(int tries = 0; tries < 64 && abs(remaining) > 1e-6 * abs(h); ++tries){
+        if(abs(sub) > abs(remaining)) sub = remaining;
+        vec2 error;
+        vec2 next = cashKarp(pos, sub, error);
+        float e = length(error);
+        float allowed = tol * abs(sub);
+        if(e <= allowed || tries == 63){
+            pos = next;
+            remaining -= sub;
+            sub *= e > 0.0 ? min(5.0, 0.9 * pow(allowed / e, 0.2)) : 5.0;
+        } else {
+            sub *= max(0.1, 0.9 * pow(allowed / e, 0.25));
+        }
+    }
+    return pos;
+}
+
+// The position one step of length h along the normalized vector field from pos
+vec2 advance(vec2 pos, float h){
+    if(integrator == 1){
+        return pos + h * direction(pos + 0.5 * h * direction(pos));
+    } else if(integrator == 2){
+        vec2 k1 = direction(pos);
+        vec2 k2 = direction(pos + 0.5 * h * k1);
+        vec2 k3 = direction(pos + 0.5 * h * k2);
+        vec2 k4 = direction(pos + h * k3);
+        return pos + h / 6.0 * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+    } else if(integrator == 3){
+        return adaptiveStep(pos, h);
+    }
+    return pos + direction(pos) * h;
+}
+
 /*
 * Traverse the vector field and sample the noise image
 * @param posF Starting position
@@ -49,7 +115,7 @@ void traverse(vec2 posF , float stepSize,int steps , inout  float v , inout int
     // store the accumulated value in v and the amount of samples in c
 	vec2 pos = posF;
 	for(int i = 0; i < steps; ++i){
-		pos += normalize(texture(vfColor, pos).rg) * stepSize;
+		pos = advance(pos, stepSize);
 		v += texture(noiseColor, pos).r;
 		c++;
 	}
@@ -31,6 +31,8 @@
 
 uniform sampler2D vfColor;
 uniform ImageParameters vfParameters;
+// VectorFieldInformation::Information: 0 pass through, 1 magnitude, 2 divergence, 3 rotation
+uniform int outputType;
 in vec3 texCoord_;
 
 
@@ -65,8 +67,8 @@ float divergence(vec2 coord){
 
 float rotation(vec2 coord){
     vec2 pixelSize = vfParameters.reciprocalDimensions;
-	float dV_y = divY( vec2(coord.x, coord.y + pixelSize.y) ) - divY( vec2(coord.x, coord.y - pixelSize.y) );
-	float dV_x = divX( vec2(coord.x + pixelSize.x, coord.y) ) - divX( vec2(coord.x - pixelSize.x, coord.y) );
+	float dV_y = divY( vec2(coord.x + pixelSize.x, coord.y) ) - divY( vec2(coord.x - pixelSize.x, coord.y) );
+	float dV_x = divX( vec2(coord.x, coord.y + pixelSize.y) ) - divX( vec2(coord.x, coord.y - pixelSize.y) );
 	float dX = 2 * pixelSize.x;
 	float dY = 2 * pixelSize.y;
 
@@ -75,6 +77,15 @@ float rotation(vec2 coord){
 
 
 void main(void) {
-    float v = OUTPUT(texCoord_.xy);
+    float v;
+    if (outputType == 1) {
+        v = magnitude(texCoord_.xy);
+    } else if (outputType == 2) {
+        v = divergence(texCoord_.xy);
+    } else if (outputType == 3) {
+        v = rotation(texCoord_.xy);
+    } else {
+        v = passThrough(texCoord_.xy);
+    }
     FragData0 = vec4(v,v,v,1 );
 }
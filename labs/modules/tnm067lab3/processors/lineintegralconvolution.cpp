@@ -55,6 +55,12 @@ LineIntegralConvolution::LineIntegralConvolution()
 
     , steps_("steps", "Steps", 20, 3, 100)
     , stepSize_("stepSize", "stepSize", 0.003f, 0.0001f, 0.01f, 0.0001f)
+    , integrator_("integrator", "Integrator",
+                  {{"euler", "Euler", TNM067::LIC::Integrator::Euler},
+                   {"rk2", "RK2 (Midpoint)", TNM067::LIC::Integrator::RK2},
+                   {"rk4", "RK4", TNM067::LIC::Integrator::RK4},
+                   {"rk45", "RK45 (Adaptive)", TNM067::LIC::Integrator::RK45}})
+    , tolerance_("tolerance", "Tolerance", 0.001f, 0.000001f, 0.1f, 0.000001f)
 
     , shader_("lineintegralconvolution.vert","lineintegralconvolution.frag")
 {
@@ -64,6 +70,12 @@ LineIntegralConvolution::LineIntegralConvolution()
     addPort(outport_);
     addProperty(steps_ );
     addProperty(stepSize_);
+    addProperty(integrator_);
+    addProperty(tolerance_);
+    integrator_.onChange([this]() {
+        tolerance_.setVisible(integrator_.get() == TNM067::LIC::Integrator::RK45);
+    });
+    tolerance_.setVisible(false);
 
     shader_.onReload([this]() {invalidate(InvalidationLevel::InvalidOutput); });
 }
@@ -76,7 +88,8 @@ void LineIntegralConvolution::process() {
     utilgl::bindAndSetUniforms(shader_, units, vf_, ImageType::ColorOnly);
     utilgl::bindAndSetUniforms(shader_, units, noise_, ImageType::ColorOnly);
 
-    utilgl::setUniforms(shader_, outport_, steps_, stepSize_);
+    utilgl::setUniforms(shader_, outport_, steps_, stepSize_, tolerance_);
+    shader_.setUniform("integrator", static_cast<int>(integrator_.get()));
 
     utilgl::singleDrawImagePlaneRect();
     shader_.deactivate();
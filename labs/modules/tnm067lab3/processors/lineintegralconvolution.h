@@ -35,7 +35,9 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/properties/optionproperty.h>
 #include <modules/opengl/shader/shader.h>
+#include <modules/tnm067lab3/utils/lic.h>
 
 namespace inviwo {
 
@@ -56,6 +58,8 @@ private:
 
     IntProperty steps_;
     FloatProperty stepSize_;
+    TemplateOptionProperty<TNM067::LIC::Integrator> integrator_;
+    FloatProperty tolerance_;
 
     Shader shader_;
 
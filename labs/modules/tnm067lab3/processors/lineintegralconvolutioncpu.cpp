@@ -0,0 +1,191 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/processors/lineintegralconvolutioncpu.h>
+#include <modules/tnm067lab3/utils/layerfield.h>
+#include <modules/tnm067common/utils/parallelutils.h>
+#include <inviwo/core/util/glmconvert.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <limits>
+
+namespace inviwo {
+
+const ProcessorInfo LineIntegralConvolutionCPU::processorInfo_{
+    "org.inviwo.LineIntegralConvolutionCPU",  // Class identifier
+    "Line Integral Convolution CPU",          // Display name
+    "Vector Field Visualization",             // Category
+    CodeState::Experimental,                  // Code state
+    Tags::None,                               // Tags
+};
+const ProcessorInfo LineIntegralConvolutionCPU::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+LineIntegralConvolutionCPU::LineIntegralConvolutionCPU()
+    : Processor()
+    , vf_("vf")
+    , noise_("noise")
+    , outport_("outport")
+    , steps_("steps", "Steps", 20, 3, 100)
+    , stepSize_("stepSize", "stepSize", 0.003f, 0.0001f, 0.01f, 0.0001f)
+    , integrator_("integrator", "Integrator",
+                  {{"euler", "Euler", TNM067::LIC::Integrator::Euler},
+                   {"rk2", "RK2 (Midpoint)", TNM067::LIC::Integrator::RK2},
+                   {"rk4", "RK4", TNM067::LIC::Integrator::RK4},
+                   {"rk45", "RK45 (Adaptive)", TNM067::LIC::Integrator::RK45}})
+    , tolerance_("tolerance", "Tolerance", 0.001f, 0.000001f, 0.1f, 0.000001f)
+    , mode_("mode", "Mode",
+            {{"perPixel", "Per Pixel", Mode::PerPixel},
+             {"fast", "Fast LIC", Mode::Fast},
+             {"animated", "Animated", Mode::Animated}})
+    , streamlineSteps_("streamlineSteps", "Streamline Steps", 100, 0, 1000)
+    , minHits_("minHits", "Min Hits", 2, 1, 10)
+    , frames_("frames", "Frames", 16, 1, 256)
+    , frame_("frame", "Frame", 0, 0, 255)
+    , ripples_("ripples", "Ripples", 2.0f, 0.5f, 8.0f, 0.1f)
+    , maskNoData_("maskNoData", "Mask No Data", true)
+    , noData_("noData", "No Data Value", 1e35f, -std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max()) {
+
+    addPort(vf_);
+    addPort(noise_);
+    addPort(outport_);
+    addProperty(steps_);
+    addProperty(stepSize_);
+    addProperty(integrator_);
+    addProperty(tolerance_);
+    addProperty(mode_);
+    addProperty(streamlineSteps_);
+    addProperty(minHits_);
+    addProperty(frames_);
+    addProperty(frame_);
+    addProperty(ripples_);
+    addProperty(maskNoData_);
+    addProperty(noData_);
+
+    auto modeVisibility = [this]() {
+        const bool fast = mode_.get() == Mode::Fast;
+        const bool animated = mode_.get() == Mode::Animated;
+        streamlineSteps_.setVisible(fast);
+        minHits_.setVisible(fast);
+        frames_.setVisible(animated);
+        frame_.setVisible(animated);
+        ripples_.setVisible(animated);
+        tolerance_.setVisible(integrator_.get() == TNM067::LIC::Integrator::RK45);
+    };
+    mode_.onChange(modeVisibility);
+    integrator_.onChange(modeVisibility);
+    modeVisibility();
+    frames_.onChange([this]() { frame_.setMaxValue(frames_.get() - 1); });
+    // The cached streamlines depend on which vectors are masked
+    maskNoData_.onChange([this]() {
+        noData_.setVisible(maskNoData_.get());
+        cache_.reset();
+    });
+    noData_.onChange([this]() { cache_.reset(); });
+}
+
+// The vector field is only used for its direction, so it is read without normalization
+TNM067::LIC::VectorField LineIntegralConvolutionCPU::readVectorField() const {
+    const auto layer = vf_.getData()->getColorLayer()->getRepresentation<LayerRAM>();
+    TNM067::ValidityMask mask;
+    auto data = TNM067::readLayer<vec2>(
+        *layer, [](const auto& v) { return util::glm_convert<vec2>(v); }, noDataValue(), mask);
+    return {layer->getDimensions(), std::move(data), std::move(mask)};
+}
+
+float LineIntegralConvolutionCPU::noDataValue() const {
+    return maskNoData_.get() ? noData_.get() : std::numeric_limits<float>::infinity();
+}
+
+TNM067::LIC::Integration LineIntegralConvolutionCPU::integration() const {
+    TNM067::LIC::Integration integration;
+    integration.integrator = integrator_.get();
+    integration.tolerance = tolerance_.get();
+    return integration;
+}
+
+std::vector<float> LineIntegralConvolutionCPU::convolveAnimated(
+    const TNM067::LIC::ScalarField& noise) {
+    const size2_t dims = noise.getDimensions();
+    if (!cache_ || vf_.isChanged() || cache_->getDimensions() != dims ||
+        cache_->getSteps() != steps_.get() || cache_->getStepSize() != stepSize_.get() ||
+        cache_->getIntegration() != integration()) {
+        cache_ = util::make_unique<TNM067::LIC::StreamlineCache>(
+            readVectorField(), dims, steps_.get(), stepSize_.get(), integration());
+    }
+
+    const float phase = 2.0f * glm::pi<float>() * frame_.get() / frames_.get();
+    return cache_->convolve(noise, TNM067::LIC::animationKernel(steps_.get(), ripples_.get(),
+                                                                phase));
+}
+
+void LineIntegralConvolutionCPU::process() {
+    // The noise is read normalized, the way the shader reads it from the texture
+    const auto layer = noise_.getData()->getColorLayer()->getRepresentation<LayerRAM>();
+    const TNM067::LIC::ScalarField noise(
+        layer->getDimensions(), TNM067::readLayer<float>(*layer, [](const auto& v) {
+            return util::glm_convert_normalized<float>(v);
+        }));
+
+    const size2_t dims = noise.getDimensions();
+    std::vector<float> lic;
+    if (mode_.get() == Mode::Animated) {
+        lic = convolveAnimated(noise);
+    } else {
+        cache_.reset();
+        const auto vf = readVectorField();
+        if (mode_.get() == Mode::Fast) {
+            lic = TNM067::LIC::convolveFast(vf, noise, dims, steps_.get(), stepSize_.get(),
+                                            streamlineSteps_.get(), minHits_.get(),
+                                            integration());
+        } else {
+            lic = TNM067::LIC::convolve(vf, noise, dims, steps_.get(), stepSize_.get(),
+                                        integration());
+        }
+    }
+
+    auto img = std::make_shared<Image>(dims, DataVec4UInt8::get());
+    auto outRep = static_cast<LayerRAMPrecision<glm::u8vec4>*>(
+        img->getColorLayer()->getEditableRepresentation<LayerRAM>());
+    glm::u8vec4* outPixels = outRep->getDataTyped();
+    util::forEachRangeParallel(lic.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const auto v =
+                static_cast<glm::u8>(glm::clamp(lic[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+            outPixels[i] = glm::u8vec4(v, v, v, 255);
+        }
+    });
+
+    outport_.setData(img);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,106 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_LINEINTEGRALCONVOLUTIONCPU_H
+#define IVW_LINEINTEGRALCONVOLUTIONCPU_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/ports/imageport.h>
+#include <modules/tnm067lab3/utils/lic.h>
+
+#include <memory>
+
+namespace inviwo {
+
+/**
+ * Line integral convolution on the CPU, with the same inputs, properties and per pixel result
+ * as LineIntegralConvolution, for machines without a GPU. The output has the dimensions of the
+ * noise image.
+ *
+ * The Fast mode reuses long streamlines for all the pixels they pass, see
+ * TNM067::LIC::convolveFast. The Animated mode renders frame Frame of a looping animation of
+ * Frames frames, with a phase shifted ripple kernel. The streamlines are cached as long as the
+ * vector field, the output size and the steps stay the same, so stepping through the frames
+ * or changing the noise only convolves again.
+ *
+ * Vectors equal to No Data Value, and non finite vectors, are masked out while the field is
+ * read and are left out when the field is sampled, see TNM067::LIC::Field.
+ */
+class IVW_MODULE_TNM067LAB3_API LineIntegralConvolutionCPU : public Processor {
+public:
+    enum class Mode {
+        PerPixel,  // One streamline per pixel, like the shader
+        Fast,      // Streamlines shared between pixels
+        Animated   // Cached streamlines, phase shifted kernel per frame
+    };
+
+    LineIntegralConvolutionCPU();
+    virtual ~LineIntegralConvolutionCPU() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    TNM067::LIC::VectorField readVectorField() const;
+    TNM067::LIC::Integration integration() const;
+    // The sentinel of vectors without data, infinity if there is none
+    float noDataValue() const;
+    // Convolves frame_ with the cached streamlines, integrating them again if needed
+    std::vector<float> convolveAnimated(const TNM067::LIC::ScalarField& noise);
+
+    ImageInport vf_;
+    ImageInport noise_;
+    ImageOutport outport_;
+
+    IntProperty steps_;
+    FloatProperty stepSize_;
+    TemplateOptionProperty<TNM067::LIC::Integrator> integrator_;
+    FloatProperty tolerance_;
+    TemplateOptionProperty<Mode> mode_;
+    IntProperty streamlineSteps_;
+    IntProperty minHits_;
+    IntProperty frames_;
+    IntProperty frame_;
+    FloatProperty ripples_;
+    BoolProperty maskNoData_;
+    FloatProperty noData_;
+
+    std::unique_ptr<TNM067::LIC::StreamlineCache> cache_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_LINEINTEGRALCONVOLUTIONCPU_H
@@ -32,6 +32,11 @@
 #include <modules/opengl/texture/textureutils.h>
 #include <modules/opengl/image/imagegl.h>
 #include <modules/opengl/shader/shaderutils.h>
+#include <modules/tnm067lab3/utils/derivedfields.h>
+#include <modules/tnm067lab3/utils/layerfield.h>
+#include <inviwo/core/util/glmconvert.h>
+
+#include <limits>
 
 namespace inviwo {
 
@@ -51,9 +56,13 @@ VectorFieldInformation::VectorFieldInformation()
     : Processor()
     , vf_("vf")
     , outport_("outport" , DataFloat32::get())
-    , outputType_("outputType","Output" , InvalidationLevel::InvalidResources)
+    , outputType_("outputType","Output")
     , outputTypeStr_("outputTypeStr","Output" , "Pass Through" , InvalidationLevel::Valid)
-    , shader_("vectorfieldinformation.vert","vectorfieldinformation.frag" , false)
+    , useCPU_("useCPU", "Compute on CPU", false)
+    , maskNoData_("maskNoData", "Mask No Data", true)
+    , noData_("noData", "No Data Value", 1e35f, -std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max())
+    , shader_("vectorfieldinformation.vert","vectorfieldinformation.frag")
 {
     
     outputTypeStr_.setReadOnly(true);
@@ -62,6 +71,9 @@ VectorFieldInformation::VectorFieldInformation()
     addPort(outport_);
     addProperty(outputType_);
     addProperty(outputTypeStr_);
+    addProperty(useCPU_);
+    addProperty(maskNoData_);
+    addProperty(noData_);
 
 
     shader_.onReload([this]() {invalidate(InvalidationLevel::InvalidOutput); });
@@ -75,35 +87,26 @@ VectorFieldInformation::VectorFieldInformation()
     outputType_.onChange([this]() {
         outputTypeStr_.set( outputType_.getSelectedDisplayName() );
     });
+
+    // The shader does not mask
+    auto maskVisibility = [this]() {
+        maskNoData_.setVisible(useCPU_.get());
+        noData_.setVisible(useCPU_.get() && maskNoData_.get());
+    };
+    useCPU_.onChange(maskVisibility);
+    maskNoData_.onChange(maskVisibility);
+    maskVisibility();
 }
     
 
-void VectorFieldInformation::initializeResources() {
-    const static std::string outputKey = "OUTPUT(texCoord_)";
-    std::string output = "";
-
-    switch (outputType_.get()) {
-        case Information::Rotation:
-            output = "rotation(texCoord_.xy);";
-            break;
-        case Information::Divergence:
-            output = "divergence(texCoord_.xy);";
-            break;
-        case Information::Magnitude:
-            output = "magnitude(texCoord_.xy);";
-            break;
-        case Information::PassThoruh:
-        default:
-            output = "passThrough(texCoord_.xy);";
-            break;
+// All outputs are in the shader and selected with the outputType uniform, so switching output
+// only redraws and never rebuilds the shader
+void VectorFieldInformation::process() {
+    if (useCPU_) {
+        processCPU();
+        return;
     }
 
-    shader_.getFragmentShaderObject()->addShaderDefine(outputKey, output);
-    shader_.build();
-
-}
-
-void VectorFieldInformation::process() {
     outport_.getEditableData()->getColorLayer()->setSwizzleMask(swizzlemasks::luminance);
     utilgl::activateAndClearTarget(outport_);
     shader_.activate();
@@ -111,11 +114,47 @@ void VectorFieldInformation::process() {
     utilgl::bindAndSetUniforms(shader_, units, vf_, ImageType::ColorOnly);
 
     utilgl::setUniforms(shader_, outport_);
+    shader_.setUniform("outputType", static_cast<int>(outputType_.get()));
 
     utilgl::singleDrawImagePlaneRect();
     shader_.deactivate();
     utilgl::deactivateCurrentTarget();
 }
 
+void VectorFieldInformation::processCPU() {
+    const auto layer = vf_.getData()->getColorLayer()->getRepresentation<LayerRAM>();
+    const size2_t dims = layer->getDimensions();
+    const float noData =
+        maskNoData_.get() ? noData_.get() : std::numeric_limits<float>::infinity();
+    TNM067::ValidityMask mask;
+    const auto field = TNM067::readLayer<vec2>(
+        *layer, [](const auto& v) { return util::glm_convert<vec2>(v); }, noData, mask);
+
+    auto img = std::make_shared<Image>(dims, DataFloat32::get());
+    img->getColorLayer()->setSwizzleMask(swizzlemasks::luminance);
+    auto out =
+        static_cast<float*>(img->getColorLayer()->getEditableRepresentation<LayerRAM>()->getData());
+
+    TNM067::DerivedFields::Outputs outputs;
+    switch (outputType_.get()) {
+        case Information::Rotation:
+            outputs.rotation = out;
+            break;
+        case Information::Divergence:
+            outputs.divergence = out;
+            break;
+        case Information::Magnitude:
+            outputs.magnitude = out;
+            break;
+        case Information::PassThoruh:
+        default:
+            outputs.passThrough = out;
+            break;
+    }
+    TNM067::DerivedFields::compute(field.data(), dims, outputs, mask);
+
+    outport_.setData(img);
+}
+
 } // namespace
 
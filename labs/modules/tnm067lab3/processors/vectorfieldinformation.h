@@ -37,6 +37,7 @@
 #include <inviwo/core/ports/imageport.h>
 #include <modules/opengl/shader/shader.h>
 #include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
 
 namespace inviwo {
 
@@ -55,17 +56,21 @@ public:
     VectorFieldInformation();
     virtual ~VectorFieldInformation() = default;
 
-    virtual void initializeResources() override;
     virtual void process() override;
 
-
-
 private:
+    // Computes the selected output with TNM067::DerivedFields, at the size of the vector field.
+    // Vectors equal to noData_, and non finite vectors, are masked out
+    void processCPU();
+
     ImageInport vf_;
     ImageOutport outport_;
 
     TemplateOptionProperty<Information> outputType_;
     StringProperty outputTypeStr_;
+    BoolProperty useCPU_;
+    BoolProperty maskNoData_;
+    FloatProperty noData_;
 
     Shader shader_;
 };
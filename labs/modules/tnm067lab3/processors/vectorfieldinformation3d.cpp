@@ -0,0 +1,131 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/processors/vectorfieldinformation3d.h>
+#include <modules/tnm067lab3/utils/derivedfields.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/glmconvert.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace inviwo {
+
+const ProcessorInfo VectorFieldInformation3D::processorInfo_{
+    "org.inviwo.VectorFieldInformation3D",  // Class identifier
+    "Vector Field Information 3D",          // Display name
+    "Vector Field Visualization",           // Category
+    CodeState::Experimental,                // Code state
+    Tags::None,                             // Tags
+};
+const ProcessorInfo VectorFieldInformation3D::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+VectorFieldInformation3D::VectorFieldInformation3D()
+    : Processor()
+    , vf_("vf")
+    , divergence_("divergence")
+    , curlMagnitude_("curlMagnitude")
+    , qCriterion_("qCriterion")
+    , lambda2_("lambda2")
+    , maskNoData_("maskNoData", "Mask No Data", true)
+    , noData_("noData", "No Data Value", 1e35f, -std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max()) {
+
+    addPort(vf_);
+    addPort(divergence_);
+    addPort(curlMagnitude_);
+    addPort(qCriterion_);
+    addPort(lambda2_);
+    addProperty(maskNoData_);
+    addProperty(noData_);
+
+    maskNoData_.onChange([this]() { noData_.setVisible(maskNoData_.get()); });
+}
+
+void VectorFieldInformation3D::process() {
+    const auto volume = vf_.getData();
+    const auto ram = volume->getRepresentation<VolumeRAM>();
+    const size3_t dims = ram->getDimensions();
+    const size_t sliceSize = dims.x * dims.y;
+
+    // Physical distance between neighbouring voxels along each axis
+    const mat3 basis = volume->getBasis();
+    const vec3 spacing(glm::length(basis[0]) / dims.x, glm::length(basis[1]) / dims.y,
+                       glm::length(basis[2]) / dims.z);
+
+    // Slices are converted and masked on demand, the vec3 copy of the whole volume is never
+    // made. Masked vectors are stored as zero
+    const float noData =
+        maskNoData_.get() ? noData_.get() : std::numeric_limits<float>::infinity();
+    auto readSlice = [&](size_t z, vec3* slice, TNM067::ValidityMask& mask) {
+        ram->dispatch<void>([&](const auto rep) {
+            const auto in = rep->getDataTyped() + z * sliceSize;
+            for (size_t i = 0; i < sliceSize; i++) {
+                slice[i] = util::glm_convert<vec3>(in[i]);
+                if (!TNM067::isValidSample(slice[i], noData)) {
+                    slice[i] = vec3(0.0f);
+                    mask.invalidate(i);
+                }
+            }
+        });
+    };
+
+    // A new float volume per connected outport, in the same space as the input
+    std::vector<std::pair<VolumeOutport*, std::shared_ptr<Volume>>> volumes;
+    auto target = [&](VolumeOutport& port) -> float* {
+        if (!port.isConnected()) return nullptr;
+        auto vol = std::make_shared<Volume>(dims, DataFloat32::get());
+        vol->setModelMatrix(volume->getModelMatrix());
+        vol->setWorldMatrix(volume->getWorldMatrix());
+        volumes.emplace_back(&port, vol);
+        return static_cast<float*>(vol->getEditableRepresentation<VolumeRAM>()->getData());
+    };
+
+    TNM067::DerivedFields::VolumeOutputs outputs;
+    outputs.divergence = target(divergence_);
+    outputs.curlMagnitude = target(curlMagnitude_);
+    outputs.qCriterion = target(qCriterion_);
+    outputs.lambda2 = target(lambda2_);
+    TNM067::DerivedFields::computeVolume(readSlice, dims, spacing, outputs);
+
+    for (auto& entry : volumes) {
+        const auto data =
+            static_cast<const float*>(entry.second->getRepresentation<VolumeRAM>()->getData());
+        const auto minMax = std::minmax_element(data, data + sliceSize * dims.z);
+        entry.second->dataMap_.dataRange = entry.second->dataMap_.valueRange =
+            dvec2(*minMax.first, *minMax.second);
+        entry.first->setData(entry.second);
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,72 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VECTORFIELDINFORMATION3D_H
+#define IVW_VECTORFIELDINFORMATION3D_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/ports/volumeport.h>
+
+namespace inviwo {
+
+/**
+ * Divergence, curl magnitude, Q-criterion and lambda2 of a 3D vector volume on the CPU. Only
+ * the quantities whose outports are connected are computed, all of them in a single pass over
+ * the volume, see TNM067::DerivedFields::computeVolume. Derivatives are taken with respect to
+ * the physical size of the volume given by its basis. Vectors equal to No Data Value, and non
+ * finite vectors, are masked out as the slices are read and get zero in every output.
+ */
+class IVW_MODULE_TNM067LAB3_API VectorFieldInformation3D : public Processor {
+public:
+    VectorFieldInformation3D();
+    virtual ~VectorFieldInformation3D() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    VolumeInport vf_;
+    VolumeOutport divergence_;
+    VolumeOutport curlMagnitude_;
+    VolumeOutport qCriterion_;
+    VolumeOutport lambda2_;
+
+    BoolProperty maskNoData_;
+    FloatProperty noData_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VECTORFIELDINFORMATION3D_H
@@ -0,0 +1,99 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/processors/vectorfieldinformationcpu.h>
+#include <modules/tnm067lab3/utils/derivedfields.h>
+#include <modules/tnm067lab3/utils/layerfield.h>
+#include <inviwo/core/util/glmconvert.h>
+
+#include <limits>
+
+namespace inviwo {
+
+const ProcessorInfo VectorFieldInformationCPU::processorInfo_{
+    "org.inviwo.VectorFieldInformationCPU",  // Class identifier
+    "Vector Field Information CPU",          // Display name
+    "Vector Field Visualization",            // Category
+    CodeState::Experimental,                 // Code state
+    Tags::None,                              // Tags
+};
+const ProcessorInfo VectorFieldInformationCPU::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+VectorFieldInformationCPU::VectorFieldInformationCPU()
+    : Processor()
+    , vf_("vf")
+    , magnitude_("magnitude", DataFloat32::get())
+    , divergence_("divergence", DataFloat32::get())
+    , rotation_("rotation", DataFloat32::get())
+    , maskNoData_("maskNoData", "Mask No Data", true)
+    , noData_("noData", "No Data Value", 1e35f, -std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max()) {
+
+    addPort(vf_);
+    addPort(magnitude_);
+    addPort(divergence_);
+    addPort(rotation_);
+    addProperty(maskNoData_);
+    addProperty(noData_);
+
+    maskNoData_.onChange([this]() { noData_.setVisible(maskNoData_.get()); });
+}
+
+void VectorFieldInformationCPU::process() {
+    const auto layer = vf_.getData()->getColorLayer()->getRepresentation<LayerRAM>();
+    const size2_t dims = layer->getDimensions();
+    const float noData =
+        maskNoData_.get() ? noData_.get() : std::numeric_limits<float>::infinity();
+    TNM067::ValidityMask mask;
+    const auto field = TNM067::readLayer<vec2>(
+        *layer, [](const auto& v) { return util::glm_convert<vec2>(v); }, noData, mask);
+
+    // A new single channel float image per connected outport, computed in place
+    std::vector<std::pair<ImageOutport*, std::shared_ptr<Image>>> images;
+    auto target = [&](ImageOutport& port) -> float* {
+        if (!port.isConnected()) return nullptr;
+        auto img = std::make_shared<Image>(dims, DataFloat32::get());
+        img->getColorLayer()->setSwizzleMask(swizzlemasks::luminance);
+        images.emplace_back(&port, img);
+        return static_cast<float*>(
+            img->getColorLayer()->getEditableRepresentation<LayerRAM>()->getData());
+    };
+
+    TNM067::DerivedFields::Outputs outputs;
+    outputs.magnitude = target(magnitude_);
+    outputs.divergence = target(divergence_);
+    outputs.rotation = target(rotation_);
+    TNM067::DerivedFields::compute(field.data(), dims, outputs, mask);
+
+    for (auto& image : images) image.first->setData(image.second);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,134 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/processors/volumesliceextractor.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace inviwo {
+
+const ProcessorInfo VolumeSliceExtractor::processorInfo_{
+    "org.inviwo.VolumeSliceExtractor",  // Class identifier
+    "Volume Slice Extractor",           // Display name
+    "Vector Field Visualization",       // Category
+    CodeState::Experimental,            // Code state
+    Tags::None,                         // Tags
+};
+const ProcessorInfo VolumeSliceExtractor::getProcessorInfo() const { return processorInfo_; }
+
+VolumeSliceExtractor::VolumeSliceExtractor()
+    : Processor()
+    , outport_("outport")
+    , file_("file", "Volume")
+    , timestep_("timestep", "Timestep", 0, 0, 0)
+    , mode_("mode", "Slice",
+            {{"z", "Z Slice", TNM067::SliceSpec::Mode::ZSlice},
+             {"plane", "Plane", TNM067::SliceSpec::Mode::Plane}})
+    , z_("z", "Z", 0, 0, 0)
+    , planeOrigin_("planeOrigin", "Plane Origin", vec3(0.0f, 0.0f, 0.5f), vec3(-1.0f),
+                   vec3(2.0f))
+    , planeU_("planeU", "Plane U", vec3(1.0f, 0.0f, 0.0f), vec3(-2.0f), vec3(2.0f))
+    , planeV_("planeV", "Plane V", vec3(0.0f, 1.0f, 0.0f), vec3(-2.0f), vec3(2.0f))
+    , planeDims_("planeDims", "Plane Dimensions", size2_t(512), size2_t(1), size2_t(4096))
+    , lookahead_("lookahead", "Prefetched Timesteps", 2, 0, 16) {
+
+    addPort(outport_);
+    file_.addNameFilter("Inviwo dat file (*.dat)");
+    addProperty(file_);
+    addProperty(timestep_);
+    addProperty(mode_);
+    addProperty(z_);
+    addProperty(planeOrigin_);
+    addProperty(planeU_);
+    addProperty(planeV_);
+    addProperty(planeDims_);
+    addProperty(lookahead_);
+
+    auto modeVisibility = [this]() {
+        const bool plane = mode_.get() == TNM067::SliceSpec::Mode::Plane;
+        z_.setVisible(!plane);
+        planeOrigin_.setVisible(plane);
+        planeU_.setVisible(plane);
+        planeV_.setVisible(plane);
+        planeDims_.setVisible(plane);
+    };
+    mode_.onChange(modeVisibility);
+    modeVisibility();
+    file_.onChange([this]() { sequence_.reset(); });
+}
+
+std::vector<std::string> VolumeSliceExtractor::seriesFiles() const {
+    const std::string directory = filesystem::getFileDirectory(file_.get());
+    std::vector<std::string> files;
+    for (const auto& name : filesystem::getDirectoryContents(directory)) {
+        if (toLower(filesystem::getFileExtension(name)) == "dat") {
+            files.push_back(directory + "/" + name);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+TNM067::SliceSpec VolumeSliceExtractor::sliceSpec() const {
+    TNM067::SliceSpec spec;
+    spec.mode = mode_.get();
+    spec.z = z_.get();
+    spec.origin = planeOrigin_.get();
+    spec.u = planeU_.get();
+    spec.v = planeV_.get();
+    spec.dims = planeDims_.get();
+    return spec;
+}
+
+void VolumeSliceExtractor::process() {
+    if (file_.get().empty()) return;
+    if (!sequence_) {
+        sequence_ = util::make_unique<TNM067::SliceSequence>(seriesFiles());
+        timestep_.setMaxValue(sequence_->size() - 1);
+        z_.setMaxValue(sequence_->getHeader(0).dimensions.z - 1);
+    }
+
+    const size_t t = std::min(timestep_.get(), sequence_->size() - 1);
+    const auto slice = sequence_->get(t, sliceSpec(), lookahead_.get());
+
+    auto img = std::make_shared<Image>(
+        slice.dims, DataFormatBase::get(NumericType::Float, slice.components, 32));
+    if (slice.components == 1) {
+        img->getColorLayer()->setSwizzleMask(swizzlemasks::luminance);
+    }
+    std::memcpy(img->getColorLayer()->getEditableRepresentation<LayerRAM>()->getData(),
+                slice.data.data(), slice.data.size() * sizeof(float));
+    outport_.setData(img);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,86 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMESLICEEXTRACTOR_H
+#define IVW_VOLUMESLICEEXTRACTOR_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/fileproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/ports/imageport.h>
+#include <modules/tnm067lab3/utils/slicesequence.h>
+
+#include <memory>
+
+namespace inviwo {
+
+/**
+ * Plays back a time series of .dat/.raw volumes as 2D slices, for the vector field processors
+ * of this module. The series is every .dat file in the directory of Volume, ordered by the
+ * timestamp in their headers. Each timestep outputs slice Z, or a resampled plane, as a float
+ * image with the components of the volume, without reading more of the raw file than the
+ * slice needs. The slices of the next Prefetched Timesteps timesteps are extracted in the
+ * background, see TNM067::SliceSequence, so stepping through Timestep does not wait for I/O.
+ */
+class IVW_MODULE_TNM067LAB3_API VolumeSliceExtractor : public Processor {
+public:
+    VolumeSliceExtractor();
+    virtual ~VolumeSliceExtractor() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    // The .dat files in the directory of file_, in name order
+    std::vector<std::string> seriesFiles() const;
+    TNM067::SliceSpec sliceSpec() const;
+
+    ImageOutport outport_;
+
+    FileProperty file_;
+    IntSizeTProperty timestep_;
+    TemplateOptionProperty<TNM067::SliceSpec::Mode> mode_;
+    IntSizeTProperty z_;
+    FloatVec3Property planeOrigin_;
+    FloatVec3Property planeU_;
+    FloatVec3Property planeV_;
+    IntSize2Property planeDims_;
+    IntSizeTProperty lookahead_;
+
+    std::unique_ptr<TNM067::SliceSequence> sequence_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMESLICEEXTRACTOR_H
@@ -0,0 +1,277 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab3/utils/derivedfields.h>
+
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+// v = (a x + b y, c x + d y) in texture coordinates, sampled at the pixel centers
+std::vector<vec2> linearField(size2_t dims, float a, float b, float c, float d) {
+    std::vector<vec2> field(dims.x * dims.y);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            const float px = (x + 0.5f) / dims.x;
+            const float py = (y + 0.5f) / dims.y;
+            field[y * dims.x + x] = vec2(a * px + b * py, c * px + d * py);
+        }
+    }
+    return field;
+}
+
+// v = a p with p the physical position of each voxel center, read one slice at a time
+TNM067::DerivedFields::SliceReader linearVolume(size3_t dims, vec3 spacing, mat3 a) {
+    return [=](size_t z, vec3* slice, TNM067::ValidityMask&) {
+        for (size_t y = 0; y < dims.y; y++) {
+            for (size_t x = 0; x < dims.x; x++) {
+                slice[y * dims.x + x] = a * (vec3(x, y, z) * spacing);
+            }
+        }
+    };
+}
+
+struct VolumeResult {
+    explicit VolumeResult(size3_t dims)
+        : divergence(dims.x * dims.y * dims.z)
+        , curlMagnitude(divergence.size())
+        , qCriterion(divergence.size())
+        , lambda2(divergence.size()) {}
+
+    TNM067::DerivedFields::VolumeOutputs outputs() {
+        TNM067::DerivedFields::VolumeOutputs res;
+        res.divergence = divergence.data();
+        res.curlMagnitude = curlMagnitude.data();
+        res.qCriterion = qCriterion.data();
+        res.lambda2 = lambda2.data();
+        return res;
+    }
+
+    std::vector<float> divergence, curlMagnitude, qCriterion, lambda2;
+};
+
+}  // namespace
+
+TEST(DerivedFieldsTests, LinearFieldTest) {
+    const size2_t dims(16, 12);
+    const auto field = linearField(dims, 1.0f, 2.0f, 3.0f, 4.0f);
+
+    std::vector<float> passThrough(field.size()), magnitude(field.size()),
+        divergence(field.size()), rotation(field.size());
+    TNM067::DerivedFields::Outputs outputs;
+    outputs.passThrough = passThrough.data();
+    outputs.magnitude = magnitude.data();
+    outputs.divergence = divergence.data();
+    outputs.rotation = rotation.data();
+    TNM067::DerivedFields::compute(field.data(), dims, outputs);
+
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            const size_t i = y * dims.x + x;
+            const vec2 v = field[i];
+            EXPECT_FLOAT_EQ(v.x, passThrough[i]);
+            EXPECT_FLOAT_EQ(std::sqrt(v.x * v.x + v.y * v.y), magnitude[i]);
+            // Exact inside, the border uses one sided differences over two pixels
+            if (x == 0 || y == 0 || x + 1 == dims.x || y + 1 == dims.y) continue;
+            EXPECT_NEAR(1.0f + 4.0f, divergence[i], 1e-4f) << "pixel " << x << ", " << y;
+            EXPECT_NEAR(3.0f - 2.0f, rotation[i], 1e-4f) << "pixel " << x << ", " << y;
+        }
+    }
+}
+
+TEST(DerivedFieldsTests, SubsetTest) {
+    // Computing a subset gives the same values as computing everything
+    const size2_t dims(9, 7);
+    std::vector<vec2> field(dims.x * dims.y);
+    for (size_t i = 0; i < field.size(); i++) {
+        field[i] = vec2(std::sin(0.7f * i), std::cos(1.3f * i));
+    }
+
+    std::vector<float> divergence(field.size()), rotation(field.size());
+    TNM067::DerivedFields::Outputs all;
+    all.divergence = divergence.data();
+    all.rotation = rotation.data();
+    TNM067::DerivedFields::compute(field.data(), dims, all);
+
+    std::vector<float> onlyRotation(field.size(), -1.0f);
+    TNM067::DerivedFields::Outputs subset;
+    subset.rotation = onlyRotation.data();
+    TNM067::DerivedFields::compute(field.data(), dims, subset);
+
+    EXPECT_EQ(rotation, onlyRotation);
+}
+
+TEST(DerivedFieldsTests, MaskTest) {
+    // Invalid pixels give zero and do not enter the differences of their neighbours
+    const size2_t dims(8, 6);
+    auto field = linearField(dims, 1.0f, 2.0f, 3.0f, 4.0f);
+    TNM067::ValidityMask mask(field.size());
+    for (size_t i : {19, 20, 44}) {
+        field[i] = vec2(1e35f);
+        mask.invalidate(i);
+    }
+
+    std::vector<float> magnitude(field.size()), divergence(field.size()),
+        rotation(field.size());
+    TNM067::DerivedFields::Outputs outputs;
+    outputs.magnitude = magnitude.data();
+    outputs.divergence = divergence.data();
+    outputs.rotation = rotation.data();
+    TNM067::DerivedFields::compute(field.data(), dims, outputs, mask);
+
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            const size_t i = y * dims.x + x;
+            if (!mask[i]) {
+                EXPECT_EQ(0.0f, magnitude[i]);
+                EXPECT_EQ(0.0f, divergence[i]);
+                EXPECT_EQ(0.0f, rotation[i]);
+                continue;
+            }
+            // One sided differences are exact for a linear field
+            if (x == 0 || y == 0 || x + 1 == dims.x || y + 1 == dims.y) continue;
+            EXPECT_NEAR(1.0f + 4.0f, divergence[i], 1e-4f) << "pixel " << x << ", " << y;
+            EXPECT_NEAR(3.0f - 2.0f, rotation[i], 1e-4f) << "pixel " << x << ", " << y;
+        }
+    }
+}
+
+TEST(DerivedFieldsTests, SymmetricEigenvaluesTest) {
+    EXPECT_EQ(dvec3(-2.0, 1.0, 3.0),
+              TNM067::DerivedFields::symmetricEigenvalues(
+                  dmat3(dvec3(3.0, 0.0, 0.0), dvec3(0.0, -2.0, 0.0), dvec3(0.0, 0.0, 1.0))));
+
+    // Eigenvalues 1, 3 and 4
+    const dmat3 m(dvec3(2.0, 1.0, 0.0), dvec3(1.0, 2.0, 0.0), dvec3(0.0, 0.0, 4.0));
+    const dvec3 e = TNM067::DerivedFields::symmetricEigenvalues(m);
+    EXPECT_NEAR(1.0, e.x, 1e-12);
+    EXPECT_NEAR(3.0, e.y, 1e-12);
+    EXPECT_NEAR(4.0, e.z, 1e-12);
+}
+
+TEST(DerivedFieldsTests, VolumeRotationTest) {
+    // Rigid rotation around z: a vortex everywhere
+    const size3_t dims(6, 5, 4);
+    const vec3 spacing(0.5f, 0.25f, 2.0f);
+    const mat3 a(vec3(0, 1, 0), vec3(-1, 0, 0), vec3(0, 0, 0));
+    VolumeResult res(dims);
+    TNM067::DerivedFields::computeVolume(linearVolume(dims, spacing, a), dims, spacing,
+                                         res.outputs());
+
+    for (size_t i = 0; i < res.divergence.size(); i++) {
+        EXPECT_NEAR(0.0f, res.divergence[i], 1e-5f) << "voxel " << i;
+        EXPECT_NEAR(2.0f, res.curlMagnitude[i], 1e-5f) << "voxel " << i;
+        EXPECT_NEAR(1.0f, res.qCriterion[i], 1e-5f) << "voxel " << i;
+        EXPECT_NEAR(-1.0f, res.lambda2[i], 1e-5f) << "voxel " << i;
+    }
+}
+
+TEST(DerivedFieldsTests, VolumeStrainTest) {
+    // Pure strain: no rotation, no vortex
+    const size3_t dims(4, 4, 5);
+    const vec3 spacing(1.0f);
+    const mat3 a(vec3(1, 0, 0), vec3(0, -1, 0), vec3(0, 0, 0));
+    VolumeResult res(dims);
+    TNM067::DerivedFields::computeVolume(linearVolume(dims, spacing, a), dims, spacing,
+                                         res.outputs());
+
+    for (size_t i = 0; i < res.divergence.size(); i++) {
+        EXPECT_NEAR(0.0f, res.divergence[i], 1e-5f) << "voxel " << i;
+        EXPECT_NEAR(0.0f, res.curlMagnitude[i], 1e-5f) << "voxel " << i;
+        EXPECT_NEAR(-1.0f, res.qCriterion[i], 1e-5f) << "voxel " << i;
+        EXPECT_NEAR(1.0f, res.lambda2[i], 1e-5f) << "voxel " << i;
+    }
+}
+
+TEST(DerivedFieldsTests, VolumeMaskTest) {
+    // A rigid rotation with holes of no data, the reader masks them
+    const size3_t dims(6, 5, 4);
+    const vec3 spacing(1.0f);
+    const mat3 a(vec3(0, 1, 0), vec3(-1, 0, 0), vec3(0, 0, 0));
+    const float noData = 1e35f;
+    auto isHole = [&](size_t x, size_t y, size_t z) {
+        return (x == 2 && y == 2) || (x == 3 && y == 2 && z == 2);
+    };
+    auto reader = [&](size_t z, vec3* slice, TNM067::ValidityMask& mask) {
+        linearVolume(dims, spacing, a)(z, slice, mask);
+        for (size_t y = 0; y < dims.y; y++) {
+            for (size_t x = 0; x < dims.x; x++) {
+                const size_t i = y * dims.x + x;
+                if (isHole(x, y, z)) slice[i] = vec3(noData);
+                if (!TNM067::isValidSample(slice[i], noData)) mask.invalidate(i);
+            }
+        }
+    };
+
+    VolumeResult res(dims);
+    TNM067::DerivedFields::computeVolume(reader, dims, spacing, res.outputs(), 2);
+
+    for (size_t z = 0; z < dims.z; z++) {
+        for (size_t y = 0; y < dims.y; y++) {
+            for (size_t x = 0; x < dims.x; x++) {
+                const size_t i = (z * dims.y + y) * dims.x + x;
+                const bool hole = isHole(x, y, z);
+                EXPECT_NEAR(0.0f, res.divergence[i], 1e-5f) << "voxel " << i;
+                EXPECT_NEAR(hole ? 0.0f : 2.0f, res.curlMagnitude[i], 1e-5f) << "voxel " << i;
+                EXPECT_NEAR(hole ? 0.0f : 1.0f, res.qCriterion[i], 1e-5f) << "voxel " << i;
+                EXPECT_NEAR(hole ? 0.0f : -1.0f, res.lambda2[i], 1e-5f) << "voxel " << i;
+            }
+        }
+    }
+}
+
+TEST(DerivedFieldsTests, VolumeSlabsTest) {
+    // The slab split does not change the result
+    const size3_t dims(7, 6, 11);
+    auto reader = [&](size_t z, vec3* slice, TNM067::ValidityMask&) {
+        for (size_t i = 0; i < dims.x * dims.y; i++) {
+            const float t = static_cast<float>(z * dims.x * dims.y + i);
+            slice[i] = vec3(std::sin(0.7f * t), std::cos(1.3f * t), std::sin(0.2f * t));
+        }
+    };
+
+    VolumeResult single(dims);
+    TNM067::DerivedFields::computeVolume(reader, dims, vec3(1.0f), single.outputs(), 1);
+    VolumeResult split(dims);
+    TNM067::DerivedFields::computeVolume(reader, dims, vec3(1.0f), split.outputs(), 4);
+
+    EXPECT_EQ(single.divergence, split.divergence);
+    EXPECT_EQ(single.curlMagnitude, split.curlMagnitude);
+    EXPECT_EQ(single.qCriterion, split.qCriterion);
+    EXPECT_EQ(single.lambda2, split.lambda2);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,269 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab3/utils/lic.h>
+#include <inviwo/core/util/exception.h>
+
+#include <cmath>
+
+namespace inviwo {
+
+namespace {
+
+// A vortex around the center of the domain
+TNM067::LIC::VectorField vortex(size2_t dims) {
+    std::vector<vec2> data(dims.x * dims.y);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            const vec2 p((x + 0.5f) / dims.x - 0.5f, (y + 0.5f) / dims.y - 0.5f);
+            data[y * dims.x + x] = vec2(-p.y, p.x);
+        }
+    }
+    return {dims, std::move(data)};
+}
+
+TNM067::LIC::ScalarField whiteNoise(size2_t dims) {
+    std::vector<float> data(dims.x * dims.y);
+    unsigned int state = 12345;
+    for (auto& v : data) {
+        state = state * 1664525u + 1013904223u;
+        v = static_cast<float>(state >> 8) / static_cast<float>(1 << 24);
+    }
+    return {dims, std::move(data)};
+}
+
+}  // namespace
+
+TEST(LICTests, SampleTest) {
+    // Values at the texel centers, linear in between and clamped outside
+    TNM067::LIC::ScalarField field(size2_t(2, 2), {0.0f, 1.0f, 2.0f, 3.0f});
+    EXPECT_FLOAT_EQ(0.0f, field.sample(vec2(0.25f, 0.25f)));
+    EXPECT_FLOAT_EQ(3.0f, field.sample(vec2(0.75f, 0.75f)));
+    EXPECT_FLOAT_EQ(1.5f, field.sample(vec2(0.5f, 0.5f)));
+    EXPECT_FLOAT_EQ(0.5f, field.sample(vec2(0.5f, 0.25f)));
+    EXPECT_FLOAT_EQ(0.0f, field.sample(vec2(-1.0f, 0.0f)));
+    EXPECT_FLOAT_EQ(3.0f, field.sample(vec2(2.0f, 2.0f)));
+}
+
+TEST(LICTests, MaskedSampleTest) {
+    // Invalid texels are left out of the interpolation
+    TNM067::ValidityMask mask(4);
+    mask.invalidate(1);
+    TNM067::LIC::ScalarField field(size2_t(2, 2), {0.0f, 1e35f, 2.0f, 3.0f}, mask);
+    EXPECT_FLOAT_EQ(0.0f, field.sample(vec2(0.5f, 0.25f)));
+    EXPECT_FLOAT_EQ(5.0f / 3.0f, field.sample(vec2(0.5f, 0.5f)));
+    EXPECT_FLOAT_EQ(3.0f, field.sample(vec2(0.75f, 0.5f)));
+    // No valid texel around the position
+    EXPECT_FLOAT_EQ(0.0f, field.sample(vec2(0.75f, 0.25f)));
+}
+
+TEST(LICTests, MaskedFieldTest) {
+    // Streamlines through a hole of no data stay finite and match a field without the hole
+    // away from it
+    const size2_t dims(32, 32);
+    auto vf = vortex(dims);
+    auto data = vf.getData();
+    TNM067::ValidityMask mask(data.size());
+    for (size_t y = 4; y < 8; y++) {
+        for (size_t x = 4; x < 8; x++) {
+            data[y * dims.x + x] = vec2(1e35f);
+            mask.invalidate(y * dims.x + x);
+        }
+    }
+    const TNM067::LIC::VectorField masked(dims, std::move(data), mask);
+    const auto noise = whiteNoise(dims);
+
+    const auto reference = TNM067::LIC::convolve(vf, noise, dims, 5, 0.003f);
+    const auto lic = TNM067::LIC::convolve(masked, noise, dims, 5, 0.003f);
+    for (size_t i = 0; i < lic.size(); i++) {
+        ASSERT_TRUE(std::isfinite(lic[i])) << "pixel " << i;
+        EXPECT_GE(lic[i], 0.0f);
+        EXPECT_LE(lic[i], 1.0f);
+    }
+    EXPECT_EQ(reference[20 * dims.x + 20], lic[20 * dims.x + 20]);
+}
+
+TEST(LICTests, UniformFieldTest) {
+    // Along a uniform field over a linear ramp the samples are symmetric around the start
+    const size2_t dims(64, 64);
+    TNM067::LIC::VectorField vf(dims, std::vector<vec2>(dims.x * dims.y, vec2(2.0f, 0.0f)));
+    std::vector<float> ramp(dims.x * dims.y);
+    for (size_t i = 0; i < ramp.size(); i++) ramp[i] = static_cast<float>(i % dims.x);
+    TNM067::LIC::ScalarField noise(dims, std::move(ramp));
+
+    const vec2 pos(0.5f, 0.5f);
+    EXPECT_NEAR(noise.sample(pos), TNM067::LIC::convolvePoint(vf, noise, pos, 10, 0.01f), 1e-4f);
+
+    // A vanishing field stalls the streamline, leaving the noise at the start
+    TNM067::LIC::VectorField zero(dims, std::vector<vec2>(dims.x * dims.y, vec2(0.0f)));
+    EXPECT_FLOAT_EQ(noise.sample(pos), TNM067::LIC::convolvePoint(zero, noise, pos, 10, 0.01f));
+}
+
+TEST(LICTests, TiledMatchesReferenceTest) {
+    const auto vf = vortex(size2_t(32, 32));
+    const auto noise = whiteNoise(size2_t(45, 33));
+    const size2_t dims(45, 33);
+
+    const auto reference = TNM067::LIC::convolveReference(vf, noise, dims, 20, 0.003f);
+    for (size_t tileSize : {1, 7, 32, 64}) {
+        const auto tiled = TNM067::LIC::convolve(vf, noise, dims, 20, 0.003f, {}, tileSize);
+        ASSERT_EQ(reference.size(), tiled.size());
+        for (size_t i = 0; i < reference.size(); i++) {
+            EXPECT_EQ(reference[i], tiled[i]) << "tile size " << tileSize << ", pixel " << i;
+        }
+    }
+}
+
+TEST(LICTests, FastUniformFieldTest) {
+    // With steps of exactly one pixel along a uniform field every streamline point is a pixel
+    // center, so the streamline values are the per pixel values
+    const size2_t dims(64, 8);
+    TNM067::LIC::VectorField vf(dims, std::vector<vec2>(dims.x * dims.y, vec2(1.0f, 0.0f)));
+    const auto noise = whiteNoise(dims);
+    const float stepSize = 1.0f / dims.x;
+
+    const auto reference = TNM067::LIC::convolveReference(vf, noise, dims, 5, stepSize);
+    for (int minHits : {1, 3}) {
+        const auto fast = TNM067::LIC::convolveFast(vf, noise, dims, 5, stepSize, 20, minHits);
+        ASSERT_EQ(reference.size(), fast.size());
+        for (size_t i = 0; i < reference.size(); i++) {
+            EXPECT_NEAR(reference[i], fast[i], 1e-4f) << "min hits " << minHits << ", pixel " << i;
+        }
+    }
+}
+
+TEST(LICTests, FastMatchesReferenceTest) {
+    const auto vf = vortex(size2_t(32, 32));
+    const size2_t dims(128, 128);
+    const auto noise = whiteNoise(dims);
+
+    const auto reference = TNM067::LIC::convolveReference(vf, noise, dims, 10, 0.005f);
+    const auto fast = TNM067::LIC::convolveFast(vf, noise, dims, 10, 0.005f, 50, 2);
+    ASSERT_EQ(reference.size(), fast.size());
+
+    // Close on average, the values are taken along the streamlines instead of at the centers
+    double error = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        ASSERT_TRUE(std::isfinite(fast[i])) << "pixel " << i;
+        error += std::abs(reference[i] - fast[i]);
+    }
+    EXPECT_LT(error / reference.size(), 0.05);
+}
+
+TEST(LICTests, IntegratorTest) {
+    // The streamlines of the vortex are circles around the center, measure how far each
+    // integrator drifts from the start radius after a bit more than one and a half turns
+    const auto vf = vortex(size2_t(32, 32));
+    const vec2 center(0.5f);
+    const float radius = 0.2f;
+
+    auto drift = [&](TNM067::LIC::Integrator integrator) {
+        TNM067::LIC::Integration integration;
+        integration.integrator = integrator;
+        integration.tolerance = 1e-4f;
+        vec2 pos = center + vec2(radius, 0.0f);
+        for (int i = 0; i < 100; i++) pos = TNM067::LIC::advance(vf, pos, 0.02f, integration);
+        const vec2 d = pos - center;
+        return std::abs(std::sqrt(d.x * d.x + d.y * d.y) - radius);
+    };
+
+    const float euler = drift(TNM067::LIC::Integrator::Euler);
+    const float rk2 = drift(TNM067::LIC::Integrator::RK2);
+    const float rk4 = drift(TNM067::LIC::Integrator::RK4);
+    const float rk45 = drift(TNM067::LIC::Integrator::RK45);
+    EXPECT_GT(euler, 0.05f);
+    EXPECT_LT(rk2, euler / 10.0f);
+    EXPECT_LT(rk4, rk2);
+    EXPECT_LT(rk4, 1e-4f);
+    EXPECT_LT(rk45, 1e-3f);
+
+    // Backwards undoes forwards
+    TNM067::LIC::Integration integration;
+    integration.integrator = TNM067::LIC::Integrator::RK4;
+    const vec2 start = center + vec2(radius, 0.0f);
+    const vec2 back = TNM067::LIC::advance(
+        vf, TNM067::LIC::advance(vf, start, 0.02f, integration), -0.02f, integration);
+    EXPECT_NEAR(start.x, back.x, 1e-5f);
+    EXPECT_NEAR(start.y, back.y, 1e-5f);
+}
+
+TEST(LICTests, StreamlineCacheTest) {
+    const auto vf = vortex(size2_t(32, 32));
+    const size2_t dims(40, 30);
+    const auto noise = whiteNoise(dims);
+    const int steps = 8;
+    const TNM067::LIC::StreamlineCache cache(vf, dims, steps, 0.004f);
+    ASSERT_EQ(2 * steps + 1, cache.getSamplesPerPixel());
+
+    // A box kernel gives the per pixel result
+    const std::vector<float> box(cache.getSamplesPerPixel(), 1.0f / cache.getSamplesPerPixel());
+    const auto reference = TNM067::LIC::convolveReference(vf, noise, dims, steps, 0.004f);
+    const auto cached = cache.convolve(noise, box);
+    ASSERT_EQ(reference.size(), cached.size());
+    for (size_t i = 0; i < reference.size(); i++) {
+        EXPECT_NEAR(reference[i], cached[i], 1e-5f) << "pixel " << i;
+    }
+
+    EXPECT_THROW(cache.convolve(noise, std::vector<float>(3, 1.0f)), Exception);
+}
+
+TEST(LICTests, AnimationKernelTest) {
+    const int steps = 10;
+    const float pi = 3.14159265f;
+    for (float phase : {0.0f, 1.0f, 2.0f * pi}) {
+        const auto kernel = TNM067::LIC::animationKernel(steps, 2.0f, phase);
+        ASSERT_EQ(2 * steps + 1, kernel.size());
+        float sum = 0.0f;
+        for (auto w : kernel) {
+            EXPECT_GE(w, 0.0f);
+            sum += w;
+        }
+        EXPECT_NEAR(1.0f, sum, 1e-5f);
+    }
+
+    // The animation loops, and a quarter period moves the ripples
+    const auto first = TNM067::LIC::animationKernel(steps, 2.0f, 0.0f);
+    const auto last = TNM067::LIC::animationKernel(steps, 2.0f, 2.0f * pi);
+    const auto shifted = TNM067::LIC::animationKernel(steps, 2.0f, 0.5f * pi);
+    float loopError = 0.0f;
+    float shift = 0.0f;
+    for (size_t k = 0; k < first.size(); k++) {
+        loopError = std::max(loopError, std::abs(first[k] - last[k]));
+        shift = std::max(shift, std::abs(first[k] - shifted[k]));
+    }
+    EXPECT_LT(loopError, 1e-5f);
+    EXPECT_GT(shift, 1e-2f);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,137 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab3/utils/mappedvolume.h>
+#include <modules/tnm067common/tests/unittests/tempfiles.h>
+#include <inviwo/core/util/exception.h>
+
+#include <cmath>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+const size3_t dims(5, 4, 3);
+
+vec3 voxel(size_t x, size_t y, size_t z) { return vec3(x, 10.0f * y, 100.0f * z); }
+
+// Writes name.dat and name.raw, a Vec3FLOAT32 volume of size dims with the values of voxel
+std::string writeVolume(TNM067::Testing::TempFiles& files, const std::string& name,
+                        const std::string& extraHeader = "") {
+    std::vector<vec3> data;
+    for (size_t z = 0; z < dims.z; z++) {
+        for (size_t y = 0; y < dims.y; y++) {
+            for (size_t x = 0; x < dims.x; x++) data.push_back(voxel(x, y, z));
+        }
+    }
+    return files.writeVolume(name, dims, "Vec3FLOAT32", data, extraHeader);
+}
+
+}  // namespace
+
+TEST(MappedVolumeTests, HeaderTest) {
+    TNM067::Testing::TempFiles files;
+    const auto dat = writeVolume(files, "mappedvolume-header",
+                                 "BasisVector1: 2 0 0\r\n"
+                                 "BasisVector2: 0 4 0\r\n"
+                                 "basisvector3: 0 0 6\r\n"
+                                 "DataRange: -3 5\r\n"
+                                 "WorldVector1: 1 0 0 0\r\n"
+                                 "Unit: km/h\r\n"
+                                 "nodata: 1.0000000e+35\r\n");
+
+    const auto header = TNM067::DatHeader::read(dat);
+    EXPECT_EQ(::testing::TempDir() + "mappedvolume-header.raw", header.rawFile);
+    EXPECT_EQ(dims, header.dimensions);
+    EXPECT_EQ(sizeof(vec3), header.format->getSize());
+    EXPECT_EQ(vec3(2, 0, 0), header.basis[0]);
+    EXPECT_EQ(vec3(0, 4, 0), header.basis[1]);
+    EXPECT_EQ(vec3(0, 0, 6), header.basis[2]);
+    EXPECT_EQ(vec3(-1, -2, -3), header.offset);
+    EXPECT_EQ(dvec2(-3, 5), header.dataRange);
+    EXPECT_EQ(dvec2(-3, 5), header.valueRange);
+    EXPECT_EQ(1e35, header.noData);
+}
+
+TEST(MappedVolumeTests, ViewTest) {
+    TNM067::Testing::TempFiles files;
+    const auto dat = writeVolume(files, "mappedvolume-view");
+    TNM067::MappedVolume volume(dat);
+    EXPECT_EQ(dims, volume.getDimensions());
+    EXPECT_TRUE(std::isinf(volume.getHeader().noData));
+
+    const auto all = volume.volume<vec3>();
+    for (size_t z = 0; z < dims.z; z++) {
+        const auto slice = volume.slice<vec3>(z);
+        EXPECT_EQ(size3_t(dims.x, dims.y, 1), slice.dims);
+        for (size_t y = 0; y < dims.y; y++) {
+            for (size_t x = 0; x < dims.x; x++) {
+                EXPECT_EQ(voxel(x, y, z), all(x, y, z));
+                EXPECT_EQ(voxel(x, y, z), slice(x, y, 0));
+            }
+        }
+    }
+
+    const size3_t origin(1, 2, 1);
+    const auto brick = volume.brick<vec3>(origin, size3_t(3, 2, 2));
+    volume.prefetchBrick(origin, brick.dims);
+    for (size_t z = 0; z < brick.dims.z; z++) {
+        for (size_t y = 0; y < brick.dims.y; y++) {
+            for (size_t x = 0; x < brick.dims.x; x++) {
+                EXPECT_EQ(voxel(origin.x + x, origin.y + y, origin.z + z), brick(x, y, z));
+                EXPECT_EQ(brick(x, y, z), brick.row(y, z)[x]);
+            }
+        }
+    }
+    volume.releaseBrick(origin, brick.dims);
+}
+
+TEST(MappedVolumeTests, ErrorTest) {
+    TNM067::Testing::TempFiles files;
+    const auto dat = writeVolume(files, "mappedvolume-error");
+    TNM067::MappedVolume volume(dat);
+    EXPECT_THROW(volume.slice<float>(0), Exception);
+    EXPECT_THROW(volume.slice<vec3>(dims.z), Exception);
+    EXPECT_THROW(volume.brick<vec3>(size3_t(1, 0, 0), dims), Exception);
+
+    // The header asks for more voxels than the raw file has
+    const auto large = writeVolume(files, "mappedvolume-large", "ByteOffset: 4\n");
+    EXPECT_THROW(TNM067::MappedVolume{large}, Exception);
+
+    EXPECT_THROW(TNM067::DatHeader::read(files.path("mappedvolume-missing.dat")),
+                 Exception);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,206 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/tnm067lab3/utils/slicesequence.h>
+#include <modules/tnm067common/tests/unittests/tempfiles.h>
+#include <inviwo/core/util/exception.h>
+
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+const size3_t dims(6, 5, 4);
+
+// Linear in the voxel position, so trilinear interpolation is exact inside the volume
+vec3 voxel(vec3 pos, float time) { return vec3(pos.x + time, 10.0f * pos.y, 100.0f * pos.z); }
+
+std::string writeVolume(TNM067::Testing::TempFiles& files, const std::string& name, float time,
+                        const std::string& extra = "") {
+    std::vector<vec3> data;
+    for (size_t z = 0; z < dims.z; z++) {
+        for (size_t y = 0; y < dims.y; y++) {
+            for (size_t x = 0; x < dims.x; x++) data.push_back(voxel(vec3(x, y, z), time));
+        }
+    }
+    return files.writeVolume(name, dims, "Vec3FLOAT32", data,
+                             "timestamp: " + std::to_string(time) + "\n" + extra);
+}
+
+vec3 sampleOf(const TNM067::Slice& slice, size_t x, size_t y) {
+    const float* v = slice.data.data() + (y * slice.dims.x + x) * slice.components;
+    return vec3(v[0], v[1], v[2]);
+}
+
+}  // namespace
+
+TEST(SliceSequenceTests, ZSliceTest) {
+    TNM067::Testing::TempFiles files;
+    TNM067::MappedVolume volume(writeVolume(files, "slicesequence-z", 0.0f));
+    TNM067::SliceSpec spec;
+    spec.z = 2;
+    const auto slice = TNM067::extractSlice(volume, spec);
+
+    ASSERT_EQ(size2_t(dims.x, dims.y), slice.dims);
+    ASSERT_EQ(3, slice.components);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            EXPECT_EQ(voxel(vec3(x, y, 2), 0.0f), sampleOf(slice, x, y));
+        }
+    }
+
+    spec.z = dims.z;
+    EXPECT_THROW(TNM067::extractSlice(volume, spec), Exception);
+}
+
+TEST(SliceSequenceTests, PlaneTest) {
+    TNM067::Testing::TempFiles files;
+    TNM067::MappedVolume volume(writeVolume(files, "slicesequence-plane", 0.0f));
+
+    // An oblique plane inside the voxel centers
+    TNM067::SliceSpec spec;
+    spec.mode = TNM067::SliceSpec::Mode::Plane;
+    spec.origin = vec3(0.1f, 0.15f, 0.2f);
+    spec.u = vec3(0.7f, 0.0f, 0.5f);
+    spec.v = vec3(0.1f, 0.6f, 0.1f);
+    spec.dims = size2_t(7, 9);
+    const auto slice = TNM067::extractSlice(volume, spec);
+
+    ASSERT_EQ(spec.dims, slice.dims);
+    for (size_t y = 0; y < spec.dims.y; y++) {
+        for (size_t x = 0; x < spec.dims.x; x++) {
+            const vec3 p = spec.origin + (x + 0.5f) / spec.dims.x * spec.u +
+                           (y + 0.5f) / spec.dims.y * spec.v;
+            const vec3 expected = voxel(p * vec3(dims) - 0.5f, 0.0f);
+            const vec3 result = sampleOf(slice, x, y);
+            EXPECT_NEAR(expected.x, result.x, 1e-3f) << "sample " << x << ", " << y;
+            EXPECT_NEAR(expected.y, result.y, 1e-3f) << "sample " << x << ", " << y;
+            EXPECT_NEAR(expected.z, result.z, 1e-2f) << "sample " << x << ", " << y;
+        }
+    }
+}
+
+TEST(SliceSequenceTests, PlaneBorderTest) {
+    TNM067::Testing::TempFiles files;
+    TNM067::MappedVolume volume(writeVolume(files, "slicesequence-border", 0.0f));
+
+    // The bottom face of the volume, the outer samples lie outside of the voxel centers and take
+    // the value of the border voxels
+    TNM067::SliceSpec spec;
+    spec.mode = TNM067::SliceSpec::Mode::Plane;
+    spec.origin = vec3(0.0f);
+    spec.u = vec3(1.0f, 0.0f, 0.0f);
+    spec.v = vec3(0.0f, 1.0f, 0.0f);
+    spec.dims = size2_t(2 * dims.x, 2 * dims.y);
+    const auto slice = TNM067::extractSlice(volume, spec);
+
+    ASSERT_EQ(spec.dims, slice.dims);
+    for (size_t y = 0; y < spec.dims.y; y++) {
+        for (size_t x = 0; x < spec.dims.x; x++) {
+            const vec3 p = spec.origin + (x + 0.5f) / spec.dims.x * spec.u +
+                           (y + 0.5f) / spec.dims.y * spec.v;
+            const vec3 expected =
+                voxel(glm::clamp(p * vec3(dims) - 0.5f, vec3(0.0f), vec3(dims) - 1.0f), 0.0f);
+            const vec3 result = sampleOf(slice, x, y);
+            EXPECT_NEAR(expected.x, result.x, 1e-3f) << "sample " << x << ", " << y;
+            EXPECT_NEAR(expected.y, result.y, 1e-3f) << "sample " << x << ", " << y;
+            EXPECT_NEAR(expected.z, result.z, 1e-2f) << "sample " << x << ", " << y;
+        }
+    }
+}
+
+TEST(SliceSequenceTests, PlaneNoDataTest) {
+    // The z component of every voxel in slice 1 is 100, which marks them as holding no data
+    TNM067::Testing::TempFiles files;
+    TNM067::MappedVolume volume(writeVolume(files, "slicesequence-nodata", 0.0f, "nodata: 100\n"));
+    TNM067::SliceSpec spec;
+    spec.mode = TNM067::SliceSpec::Mode::Plane;
+    spec.dims = size2_t(dims.x, dims.y);
+
+    // Halfway between slice 0 and 1 only slice 0 is used
+    spec.origin = vec3(0.0f, 0.0f, 1.0f / dims.z);
+    auto slice = TNM067::extractSlice(volume, spec);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            EXPECT_EQ(voxel(vec3(x, y, 0), 0.0f), sampleOf(slice, x, y));
+        }
+    }
+
+    // Through the centers of slice 1 there is nothing to interpolate
+    spec.origin = vec3(0.0f, 0.0f, 1.5f / dims.z);
+    slice = TNM067::extractSlice(volume, spec);
+    for (float c : slice.data) EXPECT_EQ(100.0f, c);
+}
+
+TEST(SliceSequenceTests, SequenceTest) {
+    // Written out of order, played back by timestamp
+    TNM067::Testing::TempFiles files;
+    std::vector<std::string> dats;
+    for (int i : {2, 0, 1}) {
+        dats.push_back(
+            writeVolume(files, "slicesequence-" + std::to_string(i), static_cast<float>(i)));
+    }
+    TNM067::SliceSequence sequence(dats);
+    ASSERT_EQ(3, sequence.size());
+    EXPECT_EQ(0.0, sequence.getHeader(0).timestamp);
+    EXPECT_EQ(2.0, sequence.getHeader(2).timestamp);
+
+    TNM067::SliceSpec spec;
+    spec.z = 1;
+    for (size_t t : {0, 1, 2, 0}) {
+        const auto slice = sequence.get(t, spec, 1);
+        EXPECT_EQ(voxel(vec3(3, 2, 1), static_cast<float>(t)), sampleOf(slice, 3, 2));
+        EXPECT_EQ(std::vector<size_t>{(t + 1) % 3}, sequence.getPrefetched());
+    }
+
+    // Prefetched slices of another spec are not used
+    spec.z = 3;
+    const auto slice = sequence.get(1, spec, 2);
+    EXPECT_EQ(voxel(vec3(3, 2, 3), 1.0f), sampleOf(slice, 3, 2));
+    EXPECT_EQ((std::vector<size_t>{0, 2}), sequence.getPrefetched());
+
+    EXPECT_THROW(sequence.get(3, spec), Exception);
+    EXPECT_THROW(TNM067::SliceSequence(std::vector<std::string>{}), Exception);
+
+    // Timesteps of another resolution or format are rejected up front
+    dats.push_back(files.writeVolume("slicesequence-small", size3_t(dims.x, dims.y, 2),
+                                     "Vec3FLOAT32", std::vector<vec3>(dims.x * dims.y * 2)));
+    EXPECT_THROW(TNM067::SliceSequence{dats}, Exception);
+    dats.back() = files.writeVolume("slicesequence-float", dims, "FLOAT32",
+                                    std::vector<float>(dims.x * dims.y * dims.z));
+    EXPECT_THROW(TNM067::SliceSequence{dats}, Exception);
+}
+
+}  // namespace inviwo
@@ -29,7 +29,11 @@
 
 #include <modules/tnm067lab3/tnm067lab3module.h>
 #include <modules/tnm067lab3/processors/lineintegralconvolution.h>
+#include <modules/tnm067lab3/processors/lineintegralconvolutioncpu.h>
 #include <modules/tnm067lab3/processors/vectorfieldinformation.h>
+#include <modules/tnm067lab3/processors/vectorfieldinformation3d.h>
+#include <modules/tnm067lab3/processors/vectorfieldinformationcpu.h>
+#include <modules/tnm067lab3/processors/volumesliceextractor.h>
 #include <modules/opengl/shader/shadermanager.h>
 
 namespace inviwo {
@@ -42,7 +46,11 @@ TNM067Lab3Module::TNM067Lab3Module(InviwoApplication* app) : InviwoModule(app, "
     
     // Processors
     registerProcessor<LineIntegralConvolution>();
+    registerProcessor<LineIntegralConvolutionCPU>();
     registerProcessor<VectorFieldInformation>();
+    registerProcessor<VectorFieldInformation3D>();
+    registerProcessor<VectorFieldInformationCPU>();
+    registerProcessor<VolumeSliceExtractor>();
     
     // Properties
     // registerProperty<TNM067Lab3Property>();
@@ -0,0 +1,216 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/utils/derivedfields.h>
+#include <modules/tnm067common/utils/parallelutils.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace inviwo {
+namespace TNM067 {
+namespace DerivedFields {
+
+void compute(const vec2* field, size2_t dims, const Outputs& outputs, const ValidityMask& mask) {
+    const bool derivatives = outputs.divergence || outputs.rotation;
+    // Central differences span two pixels, in texture coordinates
+    const float toDx = 0.5f * dims.x;
+    const float toDy = 0.5f * dims.y;
+
+    util::forEachRangeParallel(dims.y, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            const size_t row = y * dims.x;
+            const size_t downRow = y > 0 ? row - dims.x : row;
+            const size_t upRow = y + 1 < dims.y ? row + dims.x : row;
+
+            for (size_t x = 0; x < dims.x; x++) {
+                if (!mask[row + x]) {
+                    for (float* out : {outputs.passThrough, outputs.magnitude, outputs.divergence,
+                                       outputs.rotation}) {
+                        if (out) out[row + x] = 0.0f;
+                    }
+                    continue;
+                }
+
+                const vec2 v = field[row + x];
+                if (outputs.passThrough) outputs.passThrough[row + x] = v.x;
+                if (outputs.magnitude) {
+                    outputs.magnitude[row + x] = std::sqrt(v.x * v.x + v.y * v.y);
+                }
+                if (!derivatives) continue;
+
+                // Difference between the neighbours lo and hi. An invalid neighbour is replaced
+                // by the pixel itself, and the difference scaled up as it spans one pixel
+                auto difference = [&](size_t lo, size_t hi) -> vec2 {
+                    const bool loValid = mask[lo];
+                    const bool hiValid = mask[hi];
+                    if (loValid && hiValid) return field[hi] - field[lo];
+                    if (loValid) return 2.0f * (v - field[lo]);
+                    if (hiValid) return 2.0f * (field[hi] - v);
+                    return vec2(0.0f);
+                };
+                const vec2 dx =
+                    difference(row + (x > 0 ? x - 1 : x), row + (x + 1 < dims.x ? x + 1 : x)) *
+                    toDx;
+                const vec2 dy = difference(downRow + x, upRow + x) * toDy;
+                if (outputs.divergence) outputs.divergence[row + x] = dx.x + dy.y;
+                if (outputs.rotation) outputs.rotation[row + x] = dx.y - dy.x;
+            }
+        }
+    });
+}
+
+dvec3 symmetricEigenvalues(const dmat3& m) {
+    const double p1 = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+    if (p1 == 0.0) {
+        dvec3 e(m[0][0], m[1][1], m[2][2]);
+        if (e.x > e.y) std::swap(e.x, e.y);
+        if (e.y > e.z) std::swap(e.y, e.z);
+        if (e.x > e.y) std::swap(e.x, e.y);
+        return e;
+    }
+
+    const double q = (m[0][0] + m[1][1] + m[2][2]) / 3.0;
+    const double p2 = (m[0][0] - q) * (m[0][0] - q) + (m[1][1] - q) * (m[1][1] - q) +
+                      (m[2][2] - q) * (m[2][2] - q) + 2.0 * p1;
+    const double p = std::sqrt(p2 / 6.0);
+    const dmat3 b = (1.0 / p) * (m - q * dmat3(1.0));
+    const double r = std::min(std::max(glm::determinant(b) / 2.0, -1.0), 1.0);
+    const double phi = std::acos(r) / 3.0;
+
+    const double largest = q + 2.0 * p * std::cos(phi);
+    const double smallest = q + 2.0 * p * std::cos(phi + 2.0 * glm::pi<double>() / 3.0);
+    return dvec3(smallest, 3.0 * q - largest - smallest, largest);
+}
+
+void computeVolume(const SliceReader& readSlice, size3_t dims, vec3 spacing,
+                   const VolumeOutputs& outputs, size_t slabs) {
+    const size_t sliceSize = dims.x * dims.y;
+    if (slabs == 0) {
+        slabs = std::max<size_t>(util::detail::poolSize(), 1);
+    }
+
+    // The factors of a difference over 0, 1 or 2 voxels along each axis
+    const float toDx[] = {0.0f, 1.0f / spacing.x, 0.5f / spacing.x};
+    const float toDy[] = {0.0f, 1.0f / spacing.y, 0.5f / spacing.y};
+    const float toDz[] = {0.0f, 1.0f / spacing.z, 0.5f / spacing.z};
+
+    util::forEachRangeParallel(dims.z, [&](size_t begin, size_t end) {
+        // Slice z and its mask are kept in window[z % 3] and masks[z % 3]
+        std::array<std::vector<vec3>, 3> window;
+        std::array<ValidityMask, 3> masks;
+        std::array<size_t, 3> loaded;
+        loaded.fill(dims.z);
+        auto slice = [&](size_t z) -> const vec3* {
+            auto& buffer = window[z % 3];
+            if (loaded[z % 3] != z) {
+                buffer.resize(sliceSize);
+                masks[z % 3].reset(sliceSize);
+                readSlice(z, buffer.data(), masks[z % 3]);
+                loaded[z % 3] = z;
+            }
+            return buffer.data();
+        };
+
+        for (size_t z = begin; z < end; z++) {
+            const size_t zBack = z > 0 ? z - 1 : z;
+            const size_t zFront = z + 1 < dims.z ? z + 1 : z;
+            const vec3* back = slice(zBack);
+            const vec3* center = slice(z);
+            const vec3* front = slice(zFront);
+            const ValidityMask& backMask = masks[zBack % 3];
+            const ValidityMask& mask = masks[z % 3];
+            const ValidityMask& frontMask = masks[zFront % 3];
+
+            for (size_t y = 0; y < dims.y; y++) {
+                for (size_t x = 0; x < dims.x; x++) {
+                    const size_t i = y * dims.x + x;
+                    const size_t out = z * sliceSize + i;
+                    if (!mask[i]) {
+                        for (float* o : {outputs.divergence, outputs.curlMagnitude,
+                                         outputs.qCriterion, outputs.lambda2}) {
+                            if (o) o[out] = 0.0f;
+                        }
+                        continue;
+                    }
+
+                    // Neighbours outside the volume or invalid are replaced by the voxel
+                    // itself, which makes the difference one sided
+                    const size_t left = x > 0 && mask[i - 1] ? i - 1 : i;
+                    const size_t right = x + 1 < dims.x && mask[i + 1] ? i + 1 : i;
+                    const size_t down = y > 0 && mask[i - dims.x] ? i - dims.x : i;
+                    const size_t up = y + 1 < dims.y && mask[i + dims.x] ? i + dims.x : i;
+                    const bool hasBack = zBack < z && backMask[i];
+                    const bool hasFront = zFront > z && frontMask[i];
+                    const vec3 backValue = hasBack ? back[i] : center[i];
+                    const vec3 frontValue = hasFront ? front[i] : center[i];
+
+                    // Column j of the gradient is the derivative along axis j
+                    const mat3 g((center[right] - center[left]) * toDx[right - left],
+                                 (center[up] - center[down]) * toDy[(up - down) / dims.x],
+                                 (frontValue - backValue) * toDz[hasBack + hasFront]);
+
+                    if (outputs.divergence) outputs.divergence[out] = g[0][0] + g[1][1] + g[2][2];
+                    if (outputs.curlMagnitude) {
+                        const vec3 curl(g[1][2] - g[2][1], g[2][0] - g[0][2], g[0][1] - g[1][0]);
+                        outputs.curlMagnitude[out] =
+                            std::sqrt(curl.x * curl.x + curl.y * curl.y + curl.z * curl.z);
+                    }
+                    if (!outputs.qCriterion && !outputs.lambda2) continue;
+
+                    const mat3 gt = glm::transpose(g);
+                    const mat3 s = 0.5f * (g + gt);
+                    const mat3 omega = 0.5f * (g - gt);
+                    if (outputs.qCriterion) {
+                        float omega2 = 0.0f;
+                        float s2 = 0.0f;
+                        for (int c = 0; c < 3; c++) {
+                            for (int r = 0; r < 3; r++) {
+                                omega2 += omega[c][r] * omega[c][r];
+                                s2 += s[c][r] * s[c][r];
+                            }
+                        }
+                        outputs.qCriterion[out] = 0.5f * (omega2 - s2);
+                    }
+                    if (outputs.lambda2) {
+                        const dmat3 m(s * s + omega * omega);
+                        outputs.lambda2[out] = static_cast<float>(symmetricEigenvalues(m).y);
+                    }
+                }
+            }
+        }
+    }, slabs);
+}
+
+}  // namespace DerivedFields
+}  // namespace TNM067
+}  // namespace inviwo
@@ -0,0 +1,106 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_DERIVEDFIELDS_H
+#define IVW_DERIVEDFIELDS_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/tnm067lab3/utils/validitymask.h>
+
+#include <functional>
+
+namespace inviwo {
+namespace TNM067 {
+namespace DerivedFields {
+
+/**
+ * Where compute writes each quantity, dims.x * dims.y floats in the layout of the field.
+ * Quantities with a null pointer are not computed.
+ */
+struct Outputs {
+    float* passThrough = nullptr;  // The x component
+    float* magnitude = nullptr;
+    float* divergence = nullptr;
+    float* rotation = nullptr;  // The scalar curl dv_y/dx - dv_x/dy
+};
+
+/**
+ * Computes all requested quantities of the 2D vector field in one parallel pass over the rows.
+ * The four neighbours of a pixel are loaded once and shared between divergence and rotation.
+ * The derivatives are central differences in texture coordinates, with the neighbours clamped
+ * at the border, the same as vectorfieldinformation.frag.
+ *
+ * Pixels that are invalid in mask get zero for every quantity. Next to invalid pixels the
+ * differences are one sided, so no sentinel value enters them. The mask is checked inline
+ * while the neighbours are loaded, there is no separate pass over the field.
+ */
+IVW_MODULE_TNM067LAB3_API void compute(const vec2* field, size2_t dims, const Outputs& outputs,
+                                       const ValidityMask& mask = ValidityMask());
+
+/**
+ * Where computeVolume writes each quantity, dims.x * dims.y * dims.z floats in the layout of
+ * the volume. Quantities with a null pointer are not computed.
+ */
+struct VolumeOutputs {
+    float* divergence = nullptr;
+    float* curlMagnitude = nullptr;
+    float* qCriterion = nullptr;  // (|Omega|^2 - |S|^2) / 2, positive where rotation dominates
+    float* lambda2 = nullptr;     // Middle eigenvalue of S^2 + Omega^2, negative in vortices
+};
+
+// Writes the dims.x * dims.y vectors of slice z to slice and invalidates the samples that hold
+// no data in mask, which is passed in with every sample valid
+using SliceReader = std::function<void(size_t z, vec3* slice, ValidityMask& mask)>;
+
+/**
+ * Computes all requested quantities of the 3D vector field in one pass. S and Omega are the
+ * symmetric and antisymmetric parts of the velocity gradient, which uses central differences
+ * over voxels spacing apart, one sided at the border and next to invalid voxels. Invalid voxels
+ * get zero for every quantity.
+ *
+ * The volume is split in slabs of whole slices that are processed in parallel. Each slab
+ * slides a window of three slices, read with readSlice, through its range, so every slice is
+ * read once plus once for each neighbouring slab, and the working memory is three slices per
+ * slab no matter the size of the volume. slabs = 0 uses one slab per thread.
+ */
+IVW_MODULE_TNM067LAB3_API void computeVolume(const SliceReader& readSlice, size3_t dims,
+                                             vec3 spacing, const VolumeOutputs& outputs,
+                                             size_t slabs = 0);
+
+/**
+ * The eigenvalues of the symmetric 3x3 matrix m in ascending order, computed in closed form
+ */
+IVW_MODULE_TNM067LAB3_API dvec3 symmetricEigenvalues(const dmat3& m);
+
+}  // namespace DerivedFields
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_DERIVEDFIELDS_H
@@ -0,0 +1,98 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_LAYERFIELD_H
+#define IVW_LAYERFIELD_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <modules/tnm067lab3/utils/validitymask.h>
+#include <modules/tnm067common/utils/parallelutils.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+
+/**
+ * Copies the values of the layer (row major, row 0 at the bottom) into a vector, converting
+ * each value with convert, e.g. util::glm_convert<vec2>. Dispatches on the layer format once
+ * and reads through a typed pointer.
+ */
+template <typename T, typename Convert>
+std::vector<T> readLayer(const LayerRAM& layer, Convert convert) {
+    const size2_t dims = layer.getDimensions();
+    std::vector<T> data(dims.x * dims.y);
+    layer.dispatch<void>([&](const auto rep) {
+        const auto in = rep->getDataTyped();
+        util::forEachRangeParallel(data.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) data[i] = convert(in[i]);
+        });
+    });
+    return data;
+}
+
+/**
+ * Same as above, and in the same pass marks the values that are not valid samples, see
+ * isValidSample, in mask. Those values are stored as zero, so that no sentinel or NaN reaches
+ * a kernel that ignores the mask. The mask is left empty if every value is valid.
+ */
+template <typename T, typename Convert>
+std::vector<T> readLayer(const LayerRAM& layer, Convert convert, float noData,
+                         ValidityMask& mask) {
+    const size2_t dims = layer.getDimensions();
+    const size_t size = dims.x * dims.y;
+    std::vector<T> data(size);
+    mask.reset(size);
+    layer.dispatch<void>([&](const auto rep) {
+        const auto in = rep->getDataTyped();
+        // Whole words of the mask per job so that no two jobs write the same word
+        util::forEachRangeParallel((size + 63) / 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin * 64; i < std::min(end * 64, size); i++) {
+                const T v = convert(in[i]);
+                if (isValidSample(v, noData)) {
+                    data[i] = v;
+                } else {
+                    data[i] = T(0);
+                    mask.invalidate(i);
+                }
+            }
+        });
+    });
+    if (mask.countInvalid() == 0) mask = ValidityMask();
+    return data;
+}
+
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_LAYERFIELD_H
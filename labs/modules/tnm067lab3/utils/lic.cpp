@@ -0,0 +1,334 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/utils/lic.h>
+#include <modules/tnm067common/utils/parallelutils.h>
+#include <inviwo/core/util/exception.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <cstdint>
+
+namespace inviwo {
+namespace TNM067 {
+namespace LIC {
+
+namespace {
+
+// Texture coordinate of the center of pixel (x, y)
+inline vec2 pixelCenter(size_t x, size_t y, size2_t dims) {
+    return vec2((x + 0.5f) / dims.x, (y + 0.5f) / dims.y);
+}
+
+// A filtered value assigned to a pixel by a streamline
+struct Hit {
+    std::uint32_t pixel;
+    float value;
+};
+
+// Integrates the streamline through the center of pixel seed and appends the box filtered
+// value of every point within streamlineSteps steps of the seed to hits
+void fastStreamline(const VectorField& vf, const ScalarField& noise, size2_t dims, size_t seed,
+                    int steps, float stepSize, int streamlineSteps,
+                    const Integration& integration, std::vector<vec2>& points,
+                    std::vector<float>& samples, std::vector<Hit>& hits) {
+    // Point k of the streamline is stored at k + length, k in [-length, length]
+    const int length = streamlineSteps + steps;
+    points.resize(2 * length + 1);
+    samples.resize(2 * length + 1);
+
+    const vec2 start = pixelCenter(seed % dims.x, seed / dims.x, dims);
+    points[length] = start;
+    samples[length] = noise.sample(start);
+    for (float h : {stepSize, -stepSize}) {
+        const int dir = h > 0.0f ? 1 : -1;
+        vec2 pos = start;
+        for (int k = 1; k <= length; k++) {
+            pos = advance(vf, pos, h, integration);
+            points[length + dir * k] = pos;
+            samples[length + dir * k] = noise.sample(pos);
+        }
+    }
+
+    const float norm = 1.0f / (2 * steps + 1);
+    double sum = 0.0;
+    for (int k = 0; k <= 2 * steps; k++) sum += samples[k];
+    for (int k = steps; k <= 2 * length - steps; k++) {
+        if (k > steps) sum += samples[k + steps] - samples[k - steps - 1];
+        const vec2 p = points[k] * vec2(dims);
+        if (p.x >= 0.0f && p.y >= 0.0f && p.x < dims.x && p.y < dims.y) {
+            const auto pixel = static_cast<std::uint32_t>(static_cast<size_t>(p.y) * dims.x +
+                                                          static_cast<size_t>(p.x));
+            hits.push_back({pixel, static_cast<float>(sum) * norm});
+        }
+    }
+}
+
+// Cash-Karp Runge-Kutta step of length h from pos, the fifth order solution is returned and
+// the difference to the embedded fourth order solution is stored in error
+vec2 cashKarp(const VectorField& vf, vec2 pos, float h, vec2& error) {
+    const vec2 k1 = direction(vf, pos);
+    const vec2 k2 = direction(vf, pos + h * (1.0f / 5.0f) * k1);
+    const vec2 k3 = direction(vf, pos + h * ((3.0f / 40.0f) * k1 + (9.0f / 40.0f) * k2));
+    const vec2 k4 = direction(
+        vf, pos + h * ((3.0f / 10.0f) * k1 - (9.0f / 10.0f) * k2 + (6.0f / 5.0f) * k3));
+    const vec2 k5 =
+        direction(vf, pos + h * ((-11.0f / 54.0f) * k1 + (5.0f / 2.0f) * k2 -
+                                 (70.0f / 27.0f) * k3 + (35.0f / 27.0f) * k4));
+    const vec2 k6 = direction(
+        vf, pos + h * ((1631.0f / 55296.0f) * k1 + (175.0f / 512.0f) * k2 +
+                       (575.0f / 13824.0f) * k3 + (44275.0f / 110592.0f) * k4 +
+                       (253.0f / 4096.0f) * k5));
+
+    const vec2 fifth = (37.0f / 378.0f) * k1 + (250.0f / 621.0f) * k3 +
+                       (125.0f / 594.0f) * k4 + (512.0f / 1771.0f) * k6;
+    const vec2 fourth = (2825.0f / 27648.0f) * k1 + (18575.0f / 48384.0f) * k3 +
+                        (13525.0f / 55296.0f) * k4 + (277.0f / 14336.0f) * k5 +
+                        (1.0f / 4.0f) * k6;
+    error = h * (fifth - fourth);
+    return pos + h * fifth;
+}
+
+// Advances pos by h in sub steps, each with an error of at most tolerance times its own
+// length. The errors of the sub steps add up to at most tolerance * |h| for the whole step
+vec2 adaptiveStep(const VectorField& vf, vec2 pos, float h, float tolerance) {
+    tolerance = std::max(tolerance, 1e-7f);
+    const float done = 1e-6f * std::abs(h);
+    // A bound on the number of tries, the last sub step is accepted whatever its error
+    const int maxTries = 64;
+
+    float remaining = h;
+    float sub = h;
+    for (int tries = 0; std::abs(remaining) > done; tries++) {
+        if (std::abs(sub) > std::abs(remaining)) sub = remaining;
+        vec2 error;
+        const vec2 next = cashKarp(vf, pos, sub, error);
+        const float e = std::sqrt(error.x * error.x + error.y * error.y);
+        const float allowed = tolerance * std::abs(sub);
+        if (e <= allowed || tries + 1 >= maxTries) {
+            pos = next;
+            remaining -= sub;
+            sub *= e > 0.0f ? std::min(5.0f, 0.9f * std::pow(allowed / e, 0.2f)) : 5.0f;
+        } else {
+            sub *= std::max(0.1f, 0.9f * std::pow(allowed / e, 0.25f));
+        }
+    }
+    return pos;
+}
+
+}  // namespace
+
+vec2 advance(const VectorField& vf, vec2 pos, float h, const Integration& integration) {
+    switch (integration.integrator) {
+        case Integrator::RK2:
+            return pos + h * direction(vf, pos + 0.5f * h * direction(vf, pos));
+        case Integrator::RK4: {
+            const vec2 k1 = direction(vf, pos);
+            const vec2 k2 = direction(vf, pos + 0.5f * h * k1);
+            const vec2 k3 = direction(vf, pos + 0.5f * h * k2);
+            const vec2 k4 = direction(vf, pos + h * k3);
+            return pos + h / 6.0f * (k1 + 2.0f * k2 + 2.0f * k3 + k4);
+        }
+        case Integrator::RK45:
+            return adaptiveStep(vf, pos, h, integration.tolerance);
+        case Integrator::Euler:
+        default:
+            return pos + direction(vf, pos) * h;
+    }
+}
+
+vec2 direction(const VectorField& vf, vec2 pos) {
+    const vec2 v = vf.sample(pos);
+    const float length = std::sqrt(v.x * v.x + v.y * v.y);
+    return length > 0.0f ? v / length : vec2(0.0f);
+}
+
+void traverse(const VectorField& vf, const ScalarField& noise, vec2 pos, float stepSize,
+              int steps, float& v, int& c, const Integration& integration) {
+    for (int i = 0; i < steps; ++i) {
+        pos = advance(vf, pos, stepSize, integration);
+        v += noise.sample(pos);
+        c++;
+    }
+}
+
+float convolvePoint(const VectorField& vf, const ScalarField& noise, vec2 pos, int steps,
+                    float stepSize, const Integration& integration) {
+    float v = noise.sample(pos);
+    int c = 1;
+    traverse(vf, noise, pos, stepSize, steps, v, c, integration);
+    traverse(vf, noise, pos, -stepSize, steps, v, c, integration);
+    return v / c;
+}
+
+std::vector<float> convolveReference(const VectorField& vf, const ScalarField& noise,
+                                     size2_t dims, int steps, float stepSize,
+                                     const Integration& integration) {
+    std::vector<float> out(dims.x * dims.y);
+    for (size_t y = 0; y < dims.y; y++) {
+        for (size_t x = 0; x < dims.x; x++) {
+            out[y * dims.x + x] = convolvePoint(vf, noise, pixelCenter(x, y, dims), steps,
+                                                stepSize, integration);
+        }
+    }
+    return out;
+}
+
+std::vector<float> convolve(const VectorField& vf, const ScalarField& noise, size2_t dims,
+                            int steps, float stepSize, const Integration& integration,
+                            size_t tileSize) {
+    std::vector<float> out(dims.x * dims.y);
+    tileSize = std::max<size_t>(tileSize, 1);
+    const size2_t tiles((dims.x + tileSize - 1) / tileSize, (dims.y + tileSize - 1) / tileSize);
+
+    util::forEachRangeParallel(tiles.x * tiles.y, [&](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; tile++) {
+            const size2_t first(tile % tiles.x * tileSize, tile / tiles.x * tileSize);
+            const size2_t last(std::min(first.x + tileSize, dims.x),
+                               std::min(first.y + tileSize, dims.y));
+            for (size_t y = first.y; y < last.y; y++) {
+                for (size_t x = first.x; x < last.x; x++) {
+                    out[y * dims.x + x] = convolvePoint(vf, noise, pixelCenter(x, y, dims),
+                                                        steps, stepSize, integration);
+                }
+            }
+        }
+    });
+    return out;
+}
+
+std::vector<float> convolveFast(const VectorField& vf, const ScalarField& noise, size2_t dims,
+                                int steps, float stepSize, int streamlineSteps, int minHits,
+                                const Integration& integration) {
+    std::vector<float> sum(dims.x * dims.y, 0.0f);
+    std::vector<int> count(dims.x * dims.y, 0);
+    streamlineSteps = std::max(streamlineSteps, 0);
+    minHits = std::max(minHits, 1);
+
+    // Coarse lattices first, so the long streamlines spread out over the image before the
+    // remaining gaps are filled pixel by pixel
+    for (size_t stride : {16, 8, 4, 2, 1}) {
+        std::vector<size_t> seeds;
+        for (size_t y = 0; y < dims.y; y += stride) {
+            for (size_t x = 0; x < dims.x; x += stride) {
+                if (count[y * dims.x + x] < minHits) seeds.push_back(y * dims.x + x);
+            }
+        }
+
+        // The streamline through a seed always hits it, so after the last lattice every
+        // pixel has at least one value
+        std::vector<std::vector<Hit>> hits(seeds.size());
+        util::forEachRangeParallel(seeds.size(), [&](size_t begin, size_t end) {
+            std::vector<vec2> points;
+            std::vector<float> samples;
+            for (size_t i = begin; i < end; i++) {
+                fastStreamline(vf, noise, dims, seeds[i], steps, stepSize, streamlineSteps,
+                               integration, points, samples, hits[i]);
+            }
+        });
+
+        for (const auto& seedHits : hits) {
+            for (const auto& hit : seedHits) {
+                sum[hit.pixel] += hit.value;
+                count[hit.pixel]++;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < sum.size(); i++) sum[i] /= count[i];
+    return sum;
+}
+
+StreamlineCache::StreamlineCache(const VectorField& vf, size2_t dims, int steps, float stepSize,
+                                 const Integration& integration)
+    : dims_(dims), steps_(std::max(steps, 0)), stepSize_(stepSize), integration_(integration) {
+    const size_t samples = getSamplesPerPixel();
+    positions_.resize(dims.x * dims.y * samples);
+    util::forEachRangeParallel(dims.y, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            for (size_t x = 0; x < dims.x; x++) {
+                vec2* line = positions_.data() + (y * dims.x + x) * samples + steps_;
+                const vec2 start = pixelCenter(x, y, dims);
+                line[0] = start;
+                vec2 forward = start;
+                vec2 backward = start;
+                for (int k = 1; k <= steps_; k++) {
+                    forward = advance(vf, forward, stepSize, integration);
+                    backward = advance(vf, backward, -stepSize, integration);
+                    line[k] = forward;
+                    line[-k] = backward;
+                }
+            }
+        }
+    });
+}
+
+std::vector<float> StreamlineCache::convolve(const ScalarField& noise,
+                                             const std::vector<float>& kernel) const {
+    const size_t samples = getSamplesPerPixel();
+    if (kernel.size() != samples) {
+        throw Exception("Expected a kernel of " + std::to_string(samples) + " weights, got " +
+                            std::to_string(kernel.size()),
+                        IvwContextCustom("StreamlineCache"));
+    }
+
+    std::vector<float> out(dims_.x * dims_.y);
+    util::forEachRangeParallel(out.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const vec2* line = getStreamline(i);
+            float v = 0.0f;
+            for (size_t k = 0; k < samples; k++) v += kernel[k] * noise.sample(line[k]);
+            out[i] = v;
+        }
+    });
+    return out;
+}
+
+std::vector<float> animationKernel(int steps, float ripples, float phase) {
+    const float pi = glm::pi<float>();
+    steps = std::max(steps, 0);
+    std::vector<float> kernel(2 * steps + 1);
+    float sum = 0.0f;
+    for (int k = -steps; k <= steps; k++) {
+        // s in [-1, 1] along the streamline
+        const float s = steps > 0 ? static_cast<float>(k) / steps : 0.0f;
+        const float window = 0.5f * (1.0f + std::cos(pi * s));
+        const float ripple = 0.5f * (1.0f + std::cos(pi * ripples * s - phase));
+        // Keep a small floor so the kernel never vanishes completely
+        const float w = window * (0.1f + 0.9f * ripple);
+        kernel[k + steps] = w;
+        sum += w;
+    }
+    for (auto& w : kernel) w /= sum;
+    return kernel;
+}
+
+}  // namespace LIC
+}  // namespace TNM067
+}  // namespace inviwo
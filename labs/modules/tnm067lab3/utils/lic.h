@@ -0,0 +1,256 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_LIC_H
+#define IVW_LIC_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/tnm067lab3/utils/validitymask.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+namespace LIC {
+
+/**
+ * A grid of values (row major, row 0 at the bottom) sampled the way the shaders sample a
+ * linearly filtered texture with clamp to edge: positions are texture coordinates in [0,1]
+ * and the values sit at the texel centers. Texels that are invalid in the mask are left out
+ * and the weights of the others renormalized, positions with no valid texel around them give
+ * zero.
+ */
+template <typename T>
+class Field {
+public:
+    Field() = default;
+    Field(size2_t dims, std::vector<T> data, ValidityMask mask = ValidityMask())
+        : dims_(dims), data_(std::move(data)), mask_(std::move(mask)) {}
+
+    size2_t getDimensions() const { return dims_; }
+    const std::vector<T>& getData() const { return data_; }
+    const ValidityMask& getMask() const { return mask_; }
+
+    T sample(vec2 pos) const {
+        const vec2 p = pos * vec2(dims_) - 0.5f;
+        const float fx = std::floor(p.x);
+        const float fy = std::floor(p.y);
+        const float tx = p.x - fx;
+        const float ty = p.y - fy;
+        const size_t x0 = clampIndex(fx, dims_.x);
+        const size_t x1 = clampIndex(fx + 1.0f, dims_.x);
+        const size_t y0 = clampIndex(fy, dims_.y) * dims_.x;
+        const size_t y1 = clampIndex(fy + 1.0f, dims_.y) * dims_.x;
+        if (!mask_.empty()) return sampleMasked({y0 + x0, y0 + x1, y1 + x0, y1 + x1}, tx, ty);
+        const T bottom = data_[y0 + x0] + (data_[y0 + x1] - data_[y0 + x0]) * tx;
+        const T top = data_[y1 + x0] + (data_[y1 + x1] - data_[y1 + x0]) * tx;
+        return bottom + (top - bottom) * ty;
+    }
+
+private:
+    // Bilinear interpolation between the valid ones of the texels bottom left, bottom right,
+    // top left and top right
+    T sampleMasked(const std::array<size_t, 4>& texels, float tx, float ty) const {
+        const std::array<float, 4> weights = {(1.0f - tx) * (1.0f - ty), tx * (1.0f - ty),
+                                              (1.0f - tx) * ty, tx * ty};
+        T sum(0);
+        float weight = 0.0f;
+        for (size_t i = 0; i < 4; i++) {
+            if (!mask_[texels[i]]) continue;
+            sum += data_[texels[i]] * weights[i];
+            weight += weights[i];
+        }
+        return weight > 0.0f ? sum / weight : T(0);
+    }
+
+    static size_t clampIndex(float i, size_t size) {
+        return static_cast<size_t>(std::min(std::max(i, 0.0f), static_cast<float>(size - 1)));
+    }
+
+    size2_t dims_{0};
+    std::vector<T> data_;
+    ValidityMask mask_;
+};
+
+using VectorField = Field<vec2>;
+using ScalarField = Field<float>;
+
+/**
+ * The normalized field vector at pos, or zero where the field vanishes. The shader normalizes
+ * unconditionally, which is undefined for a zero vector, here the streamline stalls instead.
+ */
+IVW_MODULE_TNM067LAB3_API vec2 direction(const VectorField& vf, vec2 pos);
+
+enum class Integrator {
+    Euler,  // One direction lookup per step, like the original shader
+    RK2,    // Midpoint method, two lookups per step
+    RK4,    // Classic Runge-Kutta, four lookups per step
+    RK45    // Cash-Karp with adaptive sub steps, six lookups per sub step
+};
+
+/**
+ * How a streamline advances from one sample to the next. Higher order integrators follow
+ * curved streamlines more closely, so larger steps, and fewer samples, give the same image.
+ */
+struct Integration {
+    Integrator integrator = Integrator::Euler;
+    // RK45 only: the largest accepted error estimate per unit of streamline length, the
+    // estimates of all sub steps along a streamline add up to at most tolerance times its length
+    float tolerance = 1e-3f;
+
+    bool operator==(const Integration& rhs) const {
+        return integrator == rhs.integrator && tolerance == rhs.tolerance;
+    }
+    bool operator!=(const Integration& rhs) const { return !(*this == rhs); }
+};
+
+/**
+ * The position one step of length h further along the normalized field from pos, negative h
+ * goes backwards. With RK45 the step is split in sub steps that are shrunk until their error
+ * estimate is within the tolerance times their length and grown again where the field is
+ * smooth, so the samples stay evenly spaced while the error is controlled.
+ */
+IVW_MODULE_TNM067LAB3_API vec2 advance(const VectorField& vf, vec2 pos, float h,
+                                       const Integration& integration = {});
+
+/**
+ * Same as traverse in lineintegralconvolution.frag: takes steps steps of length stepSize along
+ * the field from pos, adds the noise at each new position to v and counts the samples in c.
+ * A negative stepSize traverses backwards.
+ */
+IVW_MODULE_TNM067LAB3_API void traverse(const VectorField& vf, const ScalarField& noise, vec2 pos,
+                                        float stepSize, int steps, float& v, int& c,
+                                        const Integration& integration = {});
+
+/**
+ * The LIC value at pos: the mean of the noise at pos and along steps steps forward and
+ * backward, as computed per fragment by lineintegralconvolution.frag.
+ */
+IVW_MODULE_TNM067LAB3_API float convolvePoint(const VectorField& vf, const ScalarField& noise,
+                                              vec2 pos, int steps, float stepSize,
+                                              const Integration& integration = {});
+
+/**
+ * LIC image of dims pixels, one pixel after another on the calling thread. Kept as the
+ * reference the faster versions are validated against.
+ */
+IVW_MODULE_TNM067LAB3_API std::vector<float> convolveReference(const VectorField& vf,
+                                                               const ScalarField& noise,
+                                                               size2_t dims, int steps,
+                                                               float stepSize,
+                                                               const Integration& integration = {});
+
+/**
+ * LIC image of dims pixels, with the same per pixel result as convolveReference. The image is
+ * split in tiles of tileSize x tileSize pixels that are processed in parallel, the streamlines
+ * of neighbouring pixels in a tile run close to each other and read the same parts of the
+ * fields.
+ */
+IVW_MODULE_TNM067LAB3_API std::vector<float> convolve(const VectorField& vf,
+                                                      const ScalarField& noise, size2_t dims,
+                                                      int steps, float stepSize,
+                                                      const Integration& integration = {},
+                                                      size_t tileSize = 32);
+
+/**
+ * Fast LIC (Stalling and Hege): instead of integrating a new streamline for every pixel, long
+ * streamlines of streamlineSteps steps in each direction (plus steps more for the kernel) are
+ * integrated from seed pixels, and a running box filter of 2 * steps + 1 samples slides along
+ * them. Every streamline point assigns its filtered value to the pixel it lies in, and only
+ * pixels with fewer than minHits values are used as seeds. The cost is roughly one
+ * streamline sample per pixel and hit, independent of steps.
+ *
+ * The values are taken at the streamline points instead of at the pixel centers, so the result
+ * is close to, but not the same as, convolveReference. Seeds are placed on successively finer
+ * lattices of pixels, the streamlines of each lattice are integrated in parallel and their
+ * values are merged in seed order, so the result does not depend on the thread count.
+ */
+IVW_MODULE_TNM067LAB3_API std::vector<float> convolveFast(const VectorField& vf,
+                                                          const ScalarField& noise,
+                                                          size2_t dims, int steps,
+                                                          float stepSize, int streamlineSteps,
+                                                          int minHits,
+                                                          const Integration& integration = {});
+
+/**
+ * The streamline sample positions of every pixel of a LIC image, integrated once so that
+ * several images of the same vector field, like the frames of an animation, only have to
+ * convolve the noise. Sample k of a pixel is at k - steps steps along the field from the pixel
+ * center, the same positions as visited by convolvePoint. Takes 8 * (2 * steps + 1) bytes per
+ * pixel.
+ */
+class IVW_MODULE_TNM067LAB3_API StreamlineCache {
+public:
+    StreamlineCache(const VectorField& vf, size2_t dims, int steps, float stepSize,
+                    const Integration& integration = {});
+
+    size2_t getDimensions() const { return dims_; }
+    int getSteps() const { return steps_; }
+    float getStepSize() const { return stepSize_; }
+    const Integration& getIntegration() const { return integration_; }
+    size_t getSamplesPerPixel() const { return 2 * steps_ + 1; }
+
+    // The getSamplesPerPixel() positions of the streamline through pixel (row major index)
+    const vec2* getStreamline(size_t pixel) const {
+        return positions_.data() + pixel * getSamplesPerPixel();
+    }
+
+    /**
+     * The LIC image of the noise where sample k of every streamline is weighted by kernel[k].
+     * The kernel has getSamplesPerPixel() weights and is expected to sum to one.
+     */
+    std::vector<float> convolve(const ScalarField& noise, const std::vector<float>& kernel) const;
+
+private:
+    size2_t dims_;
+    int steps_;
+    float stepSize_;
+    Integration integration_;
+    std::vector<vec2> positions_;
+};
+
+/**
+ * The 2 * steps + 1 weights of a periodic, phase shifted LIC kernel (Cabral and Leedom): a
+ * Hann window over the streamline times a ripple with ripples periods over the kernel, shifted
+ * by phase radians along the flow. Normalized to sum to one. Convolving the same noise with
+ * phase going from 0 to 2 pi gives a looping animation where the texture moves along the
+ * field.
+ */
+IVW_MODULE_TNM067LAB3_API std::vector<float> animationKernel(int steps, float ripples,
+                                                             float phase);
+
+}  // namespace LIC
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_LIC_H
@@ -0,0 +1,220 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/utils/mappedvolume.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace inviwo {
+namespace TNM067 {
+
+namespace {
+
+std::string trim(const std::string& str) {
+    const auto begin = str.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    const auto end = str.find_last_not_of(" \t\r\n");
+    return str.substr(begin, end - begin + 1);
+}
+
+std::string toLower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+
+bool isAbsolute(const std::string& path) {
+    return (!path.empty() && (path[0] == '/' || path[0] == '\\')) ||
+           (path.size() > 1 && path[1] == ':');
+}
+
+std::string directoryOf(const std::string& path) {
+    const auto slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+}
+
+}  // namespace
+
+DatHeader DatHeader::read(const std::string& datFile) {
+    std::ifstream in(datFile);
+    if (!in) throw Exception("Could not open " + datFile, IvwContextCustom("DatHeader"));
+
+    DatHeader header;
+    std::string formatName;
+    bool hasOffset = false;
+    bool hasValueRange = false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        const std::string key = toLower(trim(line.substr(0, colon)));
+        const std::string text = trim(line.substr(colon + 1));
+        std::istringstream value(text);
+
+        if (key == "rawfile") {
+            header.rawFile = text;
+        } else if (key == "resolution" || key == "dimension") {
+            value >> header.dimensions.x >> header.dimensions.y >> header.dimensions.z;
+        } else if (key == "format") {
+            value >> formatName;
+        } else if (key == "basisvector1" || key == "basisvector2" || key == "basisvector3") {
+            auto& column = header.basis[key.back() - '1'];
+            value >> column.x >> column.y >> column.z;
+        } else if (key == "offset") {
+            value >> header.offset.x >> header.offset.y >> header.offset.z;
+            hasOffset = true;
+        } else if (key == "datarange") {
+            value >> header.dataRange.x >> header.dataRange.y;
+        } else if (key == "valuerange") {
+            value >> header.valueRange.x >> header.valueRange.y;
+            hasValueRange = true;
+        } else if (key == "byteoffset") {
+            value >> header.byteOffset;
+        } else if (key == "nodata") {
+            value >> header.noData;
+        } else if (key == "timestamp") {
+            value >> header.timestamp;
+        } else if (key == "duration") {
+            value >> header.duration;
+        }
+        if (value.fail()) {
+            throw Exception("Could not parse '" + line + "' in " + datFile,
+                            IvwContextCustom("DatHeader"));
+        }
+    }
+
+    if (header.rawFile.empty()) {
+        throw Exception("No RawFile in " + datFile, IvwContextCustom("DatHeader"));
+    }
+    if (header.dimensions.x * header.dimensions.y * header.dimensions.z == 0) {
+        throw Exception("No or empty Resolution in " + datFile, IvwContextCustom("DatHeader"));
+    }
+    header.format = DataFormatBase::get(formatName);
+    if (!header.format) {
+        throw Exception("Unknown Format '" + formatName + "' in " + datFile,
+                        IvwContextCustom("DatHeader"));
+    }
+
+    if (!isAbsolute(header.rawFile)) header.rawFile = directoryOf(datFile) + header.rawFile;
+    if (!hasOffset) header.offset = -0.5f * (header.basis[0] + header.basis[1] + header.basis[2]);
+    if (!hasValueRange) header.valueRange = header.dataRange;
+    return header;
+}
+
+MappedVolume::MappedVolume(const std::string& datFile)
+    : MappedVolume(DatHeader::read(datFile)) {}
+
+MappedVolume::MappedVolume(DatHeader header)
+    : header_(std::move(header)), file_(MappedFile::openRead(header_.rawFile)) {
+    const size3_t dims = header_.dimensions;
+    const size_t required = header_.byteOffset + getVoxelSize() * dims.x * dims.y * dims.z;
+    if (file_.size() < required) {
+        throw Exception(header_.rawFile + " is " + std::to_string(file_.size()) +
+                            " bytes, expected at least " + std::to_string(required),
+                        IvwContextCustom("MappedVolume"));
+    }
+    file_.adviseRandom();
+}
+
+void MappedVolume::prefetchSlice(size_t z) const {
+    checkBrick(size3_t(0, 0, z), size3_t(header_.dimensions.x, header_.dimensions.y, 1));
+    file_.prefetch(offsetOf(size3_t(0, 0, z)), getSliceSize());
+}
+
+void MappedVolume::releaseSlice(size_t z) const {
+    checkBrick(size3_t(0, 0, z), size3_t(header_.dimensions.x, header_.dimensions.y, 1));
+    file_.release(offsetOf(size3_t(0, 0, z)), getSliceSize());
+}
+
+void MappedVolume::prefetchBrick(size3_t origin, size3_t dims) const {
+    checkBrick(origin, dims);
+    adviseBrick(origin, dims, true);
+}
+
+void MappedVolume::releaseBrick(size3_t origin, size3_t dims) const {
+    checkBrick(origin, dims);
+    adviseBrick(origin, dims, false);
+}
+
+size_t MappedVolume::offsetOf(size3_t pos) const {
+    const size3_t dims = header_.dimensions;
+    return header_.byteOffset + ((pos.z * dims.y + pos.y) * dims.x + pos.x) * getVoxelSize();
+}
+
+void MappedVolume::checkType(size_t size, size_t alignment) const {
+    if (size != getVoxelSize()) {
+        throw Exception("Can not view " + std::string(header_.format->getString()) +
+                            " voxels as a type of " + std::to_string(size) + " bytes",
+                        IvwContextCustom("MappedVolume"));
+    }
+    if (header_.byteOffset % alignment != 0) {
+        throw Exception("The voxels in " + header_.rawFile + " are not aligned",
+                        IvwContextCustom("MappedVolume"));
+    }
+}
+
+void MappedVolume::checkBrick(size3_t origin, size3_t dims) const {
+    const size3_t size = header_.dimensions;
+    if (origin.x + dims.x > size.x || origin.y + dims.y > size.y || origin.z + dims.z > size.z) {
+        throw Exception("Brick outside of the volume", IvwContextCustom("MappedVolume"));
+    }
+}
+
+void MappedVolume::adviseBrick(size3_t origin, size3_t dims, bool prefetch) const {
+    const size3_t size = header_.dimensions;
+    auto advise = [&](size3_t pos, size_t voxels) {
+        if (prefetch) {
+            file_.prefetch(offsetOf(pos), voxels * getVoxelSize());
+        } else {
+            file_.release(offsetOf(pos), voxels * getVoxelSize());
+        }
+    };
+
+    // Whole rows are contiguous within a slice and whole slices across slices
+    if (dims.x == size.x && dims.y == size.y) {
+        advise(origin, dims.x * dims.y * dims.z);
+    } else if (dims.x == size.x) {
+        for (size_t z = 0; z < dims.z; z++) {
+            advise(origin + size3_t(0, 0, z), dims.x * dims.y);
+        }
+    } else {
+        for (size_t z = 0; z < dims.z; z++) {
+            for (size_t y = 0; y < dims.y; y++) advise(origin + size3_t(0, y, z), dims.x);
+        }
+    }
+}
+
+}  // namespace TNM067
+}  // namespace inviwo
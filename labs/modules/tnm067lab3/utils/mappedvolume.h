@@ -0,0 +1,173 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_MAPPEDVOLUME_H
+#define IVW_MAPPEDVOLUME_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/formats.h>
+#include <modules/tnm067common/utils/mappedfile.h>
+
+#include <limits>
+#include <string>
+
+namespace inviwo {
+namespace TNM067 {
+
+/**
+ * The fields of an Inviwo .dat volume header that describe the raw file and its placement
+ */
+struct IVW_MODULE_TNM067LAB3_API DatHeader {
+    std::string rawFile;  // Resolved against the directory of the .dat file
+    size3_t dimensions{0};
+    const DataFormatBase* format = nullptr;
+    mat3 basis{1.0f};      // Columns are BasisVector1-3
+    vec3 offset{0.0f};     // Defaults to centering the volume at the origin
+    dvec2 dataRange{0.0, 1.0};
+    dvec2 valueRange{0.0, 1.0};  // Defaults to dataRange
+    size_t byteOffset = 0;       // Bytes before the first voxel in the raw file
+    // Value of the voxels without data ("nodata"), infinite if there is none
+    double noData = std::numeric_limits<double>::infinity();
+    double timestamp = 0.0;  // Time of the volume in a series
+    double duration = 1.0;   // Time until the next volume
+
+    /**
+     * Reads the "Key: value" lines of datFile. Keys are case insensitive and keys that do not
+     * describe the layout (WorldVector, Unit, ...) are ignored. Throws an Exception if the file
+     * can not be read, a value can not be parsed or RawFile, Resolution or Format is missing.
+     */
+    static DatHeader read(const std::string& datFile);
+};
+
+/**
+ * \class MappedVolume
+ * \brief A .dat/.raw volume whose raw file is memory mapped instead of read
+ *
+ * Opening only parses the header and maps the file, no voxel data is read. Slices and bricks
+ * are views straight into the mapping, so only the pages under the voxels that are actually
+ * accessed are loaded from disk. The mapping is opened for random access, reading one slice
+ * does not read ahead into the next. Views stay valid as long as the MappedVolume.
+ */
+class IVW_MODULE_TNM067LAB3_API MappedVolume {
+public:
+    /**
+     * A box of voxels in the mapping, x is contiguous in memory
+     */
+    template <typename T>
+    struct View {
+        const T* data = nullptr;  // Voxel (0, 0, 0) of the view
+        size3_t dims{0};
+        size_t rowStride = 0;    // Voxels between (x, y, z) and (x, y + 1, z)
+        size_t sliceStride = 0;  // Voxels between (x, y, z) and (x, y, z + 1)
+
+        const T& operator()(size_t x, size_t y, size_t z) const {
+            return data[x + y * rowStride + z * sliceStride];
+        }
+        const T* row(size_t y, size_t z) const { return data + y * rowStride + z * sliceStride; }
+    };
+
+    /**
+     * Throws an Exception if the header can not be read or the raw file can not be mapped or
+     * is smaller than the header says
+     */
+    explicit MappedVolume(const std::string& datFile);
+    // Maps the raw file of a header that has already been read
+    explicit MappedVolume(DatHeader header);
+
+    const DatHeader& getHeader() const { return header_; }
+    size3_t getDimensions() const { return header_.dimensions; }
+    const DataFormatBase* getDataFormat() const { return header_.format; }
+    size_t getVoxelSize() const { return header_.format->getSize(); }
+    // Bytes per slice
+    size_t getSliceSize() const {
+        return getVoxelSize() * header_.dimensions.x * header_.dimensions.y;
+    }
+
+    /**
+     * The voxels of the volume, slice z or the box of size dims at origin, viewed as T. T has
+     * to have the size of a voxel, e.g. vec3 for Vec3FLOAT32. Throws an Exception if it does
+     * not or if the box is outside the volume.
+     */
+    template <typename T>
+    View<T> volume() const;
+    template <typename T>
+    View<T> slice(size_t z) const;
+    template <typename T>
+    View<T> brick(size3_t origin, size3_t dims) const;
+
+    /**
+     * Asks the OS to start loading the pages of slice z or of a brick in the background
+     */
+    void prefetchSlice(size_t z) const;
+    void prefetchBrick(size3_t origin, size3_t dims) const;
+    /**
+     * Lets the OS drop the pages of slice z or of a brick, they are reloaded if used again
+     */
+    void releaseSlice(size_t z) const;
+    void releaseBrick(size3_t origin, size3_t dims) const;
+
+private:
+    // Byte offset of voxel pos in the raw file
+    size_t offsetOf(size3_t pos) const;
+    void checkType(size_t size, size_t alignment) const;
+    void checkBrick(size3_t origin, size3_t dims) const;
+    // Calls the hint for each contiguous byte range of the brick
+    void adviseBrick(size3_t origin, size3_t dims, bool prefetch) const;
+
+    DatHeader header_;
+    MappedFile file_;
+};
+
+template <typename T>
+MappedVolume::View<T> MappedVolume::volume() const {
+    return brick<T>(size3_t(0), header_.dimensions);
+}
+
+template <typename T>
+MappedVolume::View<T> MappedVolume::slice(size_t z) const {
+    return brick<T>(size3_t(0, 0, z), size3_t(header_.dimensions.x, header_.dimensions.y, 1));
+}
+
+template <typename T>
+MappedVolume::View<T> MappedVolume::brick(size3_t origin, size3_t dims) const {
+    checkType(sizeof(T), alignof(T));
+    checkBrick(origin, dims);
+    View<T> view;
+    view.data = reinterpret_cast<const T*>(file_.data() + offsetOf(origin));
+    view.dims = dims;
+    view.rowStride = header_.dimensions.x;
+    view.sliceStride = header_.dimensions.x * header_.dimensions.y;
+    return view;
+}
+
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_MAPPEDVOLUME_H
@@ -0,0 +1,234 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/tnm067lab3/utils/slicesequence.h>
+#include <modules/tnm067lab3/utils/validitymask.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <utility>
+
+namespace inviwo {
+namespace TNM067 {
+
+namespace {
+
+// Voxel index of texture coordinate t along an axis of size voxels, and the weight of the next
+// voxel. Positions outside of the voxel centers are clamped to the border voxel.
+inline size_t voxelIndex(float t, size_t size, float& weight) {
+    const float p = std::min(std::max(t * size - 0.5f, 0.0f), static_cast<float>(size - 1));
+    const float f = std::floor(p);
+    weight = p - f;
+    return static_cast<size_t>(f);
+}
+
+template <typename T>
+void copySlice(const MappedVolume& volume, size_t z, Slice& slice) {
+    const auto view = volume.slice<T>(z);
+    std::memcpy(slice.data.data(), view.data, sizeof(T) * view.dims.x * view.dims.y);
+}
+
+template <typename T>
+void samplePlane(const MappedVolume& volume, const SliceSpec& spec, Slice& slice) {
+    const auto view = volume.volume<T>();
+    const size3_t dims = view.dims;
+    const float noData = static_cast<float>(volume.getHeader().noData);
+    const T fill(std::isfinite(noData) ? noData : 0.0f);
+    T* out = reinterpret_cast<T*>(slice.data.data());
+
+    for (size_t y = 0; y < spec.dims.y; y++) {
+        for (size_t x = 0; x < spec.dims.x; x++) {
+            const vec3 p = spec.origin + (x + 0.5f) / spec.dims.x * spec.u +
+                           (y + 0.5f) / spec.dims.y * spec.v;
+            vec3 t;
+            const size3_t p0(voxelIndex(p.x, dims.x, t.x), voxelIndex(p.y, dims.y, t.y),
+                             voxelIndex(p.z, dims.z, t.z));
+            const size3_t p1(std::min(p0.x + 1, dims.x - 1), std::min(p0.y + 1, dims.y - 1),
+                             std::min(p0.z + 1, dims.z - 1));
+
+            T sum(0.0f);
+            float weight = 0.0f;
+            for (int corner = 0; corner < 8; corner++) {
+                const bool ux = (corner & 1) != 0;
+                const bool uy = (corner & 2) != 0;
+                const bool uz = (corner & 4) != 0;
+                const T& value = view(ux ? p1.x : p0.x, uy ? p1.y : p0.y, uz ? p1.z : p0.z);
+                if (!isValidSample(value, noData)) continue;
+                const float w = (ux ? t.x : 1.0f - t.x) * (uy ? t.y : 1.0f - t.y) *
+                                (uz ? t.z : 1.0f - t.z);
+                sum += value * w;
+                weight += w;
+            }
+            out[y * spec.dims.x + x] = weight > 0.0f ? sum / weight : fill;
+        }
+    }
+}
+
+template <typename T>
+void extractTyped(const MappedVolume& volume, const SliceSpec& spec, Slice& slice) {
+    const size3_t dims = volume.getDimensions();
+    if (spec.mode == SliceSpec::Mode::ZSlice) {
+        volume.prefetchSlice(spec.z);
+        copySlice<T>(volume, spec.z, slice);
+        volume.releaseSlice(spec.z);
+        return;
+    }
+
+    // The voxel slices between the lowest and the highest corner of the plane
+    float zMin = spec.origin.z;
+    float zMax = spec.origin.z;
+    for (const vec3& corner : {spec.origin + spec.u, spec.origin + spec.v,
+                               spec.origin + spec.u + spec.v}) {
+        zMin = std::min(zMin, corner.z);
+        zMax = std::max(zMax, corner.z);
+    }
+    float unused;
+    const size_t first = voxelIndex(zMin, dims.z, unused);
+    const size_t last = std::min(voxelIndex(zMax, dims.z, unused) + 1, dims.z - 1);
+
+    for (size_t z = first; z <= last; z++) volume.prefetchSlice(z);
+    samplePlane<T>(volume, spec, slice);
+    for (size_t z = first; z <= last; z++) volume.releaseSlice(z);
+}
+
+}  // namespace
+
+bool SliceSpec::operator==(const SliceSpec& rhs) const {
+    if (mode != rhs.mode) return false;
+    if (mode == Mode::ZSlice) return z == rhs.z;
+    return origin == rhs.origin && u == rhs.u && v == rhs.v && dims == rhs.dims;
+}
+
+Slice extractSlice(const MappedVolume& volume, const SliceSpec& spec) {
+    const auto format = volume.getDataFormat();
+    if (format->getNumericType() != NumericType::Float || format->getPrecision() != 32) {
+        throw Exception("Can only slice volumes with 32 bit float components, not " +
+                            std::string(format->getString()),
+                        IvwContextCustom("SliceSequence"));
+    }
+    const size3_t dims = volume.getDimensions();
+    if (spec.mode == SliceSpec::Mode::ZSlice && spec.z >= dims.z) {
+        throw Exception("Slice " + std::to_string(spec.z) + " outside of a volume with " +
+                            std::to_string(dims.z) + " slices",
+                        IvwContextCustom("SliceSequence"));
+    }
+
+    Slice slice;
+    slice.dims = spec.mode == SliceSpec::Mode::ZSlice ? size2_t(dims.x, dims.y) : spec.dims;
+    slice.components = format->getComponents();
+    slice.data.resize(slice.dims.x * slice.dims.y * slice.components);
+    switch (slice.components) {
+        case 1:
+            extractTyped<float>(volume, spec, slice);
+            break;
+        case 2:
+            extractTyped<vec2>(volume, spec, slice);
+            break;
+        case 3:
+            extractTyped<vec3>(volume, spec, slice);
+            break;
+        case 4:
+        default:
+            extractTyped<vec4>(volume, spec, slice);
+            break;
+    }
+    return slice;
+}
+
+SliceSequence::SliceSequence(const std::vector<std::string>& datFiles) {
+    if (datFiles.empty()) {
+        throw Exception("No volumes in the sequence", IvwContextCustom("SliceSequence"));
+    }
+    for (const auto& file : datFiles) headers_.push_back(DatHeader::read(file));
+    std::stable_sort(headers_.begin(), headers_.end(),
+                     [](const DatHeader& a, const DatHeader& b) {
+                         return a.timestamp < b.timestamp;
+                     });
+    // Every timestep is extracted with the same spec and the z range is set from the first one
+    const auto& first = headers_.front();
+    for (const auto& header : headers_) {
+        if (header.dimensions != first.dimensions || header.format != first.format) {
+            throw Exception("The volumes of a sequence must have the same resolution and format, " +
+                                header.rawFile + " differs from " + first.rawFile,
+                            IvwContextCustom("SliceSequence"));
+        }
+    }
+}
+
+Slice SliceSequence::get(size_t t, const SliceSpec& spec, size_t lookahead) {
+    if (t >= headers_.size()) {
+        throw Exception("Timestep " + std::to_string(t) + " outside of a sequence of " +
+                            std::to_string(headers_.size()),
+                        IvwContextCustom("SliceSequence"));
+    }
+    if (spec != spec_) {
+        prefetched_.clear();
+        spec_ = spec;
+    }
+
+    Slice slice;
+    auto it = prefetched_.find(t);
+    if (it != prefetched_.end()) {
+        // Leave the cache consistent even if the job threw
+        auto job = std::move(it->second);
+        prefetched_.erase(it);
+        slice = job.get();
+    } else {
+        slice = extractSlice(MappedVolume(headers_[t]), spec_);
+    }
+
+    std::set<size_t> window;
+    for (size_t k = 1; k <= std::min(lookahead, headers_.size() - 1); k++) {
+        window.insert((t + k) % headers_.size());
+    }
+    for (auto i = prefetched_.begin(); i != prefetched_.end();) {
+        i = window.count(i->first) ? std::next(i) : prefetched_.erase(i);
+    }
+    // Each prefetch maps its own volume, so nothing is shared with the calling thread
+    for (size_t next : window) {
+        if (prefetched_.count(next)) continue;
+        prefetched_[next] = std::async(std::launch::async, [header = headers_[next], spec]() {
+            return extractSlice(MappedVolume(header), spec);
+        });
+    }
+    return slice;
+}
+
+std::vector<size_t> SliceSequence::getPrefetched() const {
+    std::vector<size_t> timesteps;
+    for (const auto& item : prefetched_) timesteps.push_back(item.first);
+    return timesteps;
+}
+
+}  // namespace TNM067
+}  // namespace inviwo
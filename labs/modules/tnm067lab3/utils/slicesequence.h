@@ -0,0 +1,127 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_SLICESEQUENCE_H
+#define IVW_SLICESEQUENCE_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/tnm067lab3/utils/mappedvolume.h>
+
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+
+/**
+ * The part of a volume that is extracted as a 2D slice: either the voxels of slice z, or dims
+ * samples on the plane through origin spanned by u and v. The plane is given in texture
+ * coordinates of the volume, [0,1] across each axis, and sample (x, y) is at
+ * origin + (x + 0.5) / dims.x * u + (y + 0.5) / dims.y * v.
+ */
+struct IVW_MODULE_TNM067LAB3_API SliceSpec {
+    enum class Mode { ZSlice, Plane };
+
+    Mode mode = Mode::ZSlice;
+    size_t z = 0;
+    vec3 origin{0.0f, 0.0f, 0.5f};
+    vec3 u{1.0f, 0.0f, 0.0f};
+    vec3 v{0.0f, 1.0f, 0.0f};
+    size2_t dims{256};
+
+    bool operator==(const SliceSpec& rhs) const;
+    bool operator!=(const SliceSpec& rhs) const { return !(*this == rhs); }
+};
+
+/**
+ * dims.x * dims.y samples of components floats each, row major with row 0 at the bottom, the
+ * layout of a LayerRAM of the matching float format
+ */
+struct Slice {
+    size2_t dims{0};
+    size_t components = 0;
+    std::vector<float> data;
+};
+
+/**
+ * Extracts the slice of spec from a volume with 32 bit float components. Only the pages of the
+ * slices that are needed are loaded, and they are released again afterwards. Z slices are
+ * copied as they are. Plane samples are interpolated trilinearly between the voxel centers
+ * leaving out voxels that hold the noData value of the header, samples without any valid voxel
+ * around them get the noData value, or zero if the volume has none.
+ * Throws an Exception for other formats or if z is outside the volume.
+ */
+IVW_MODULE_TNM067LAB3_API Slice extractSlice(const MappedVolume& volume, const SliceSpec& spec);
+
+/**
+ * A time series of .dat/.raw volumes that is played back one slice per timestep. While the
+ * slice of one timestep is used, the slices of the following timesteps are extracted from
+ * their memory mapped raw files on background threads, so stepping forward finds them ready
+ * instead of waiting for the disk.
+ */
+class IVW_MODULE_TNM067LAB3_API SliceSequence {
+public:
+    /**
+     * Reads the headers of datFiles and orders the volumes by their timestamp, volumes with the
+     * same timestamp keep their order. No voxel data is read. Throws an Exception if datFiles is
+     * empty, a header can not be read or the volumes differ in resolution or format.
+     */
+    explicit SliceSequence(const std::vector<std::string>& datFiles);
+    // Waits for the prefetches that are still running
+    ~SliceSequence() = default;
+
+    size_t size() const { return headers_.size(); }
+    const DatHeader& getHeader(size_t t) const { return headers_[t]; }
+
+    /**
+     * The slice of spec from timestep t, taken from the prefetched slices if it is there and
+     * extracted on the calling thread otherwise. Then starts prefetching the slices of the
+     * lookahead timesteps after t, wrapping around at the end for looping playback, and drops
+     * the prefetched slices of other timesteps or of another spec. Dropping a slice that is
+     * still being extracted waits for it, so jumping around can stall, playing forward does
+     * not. Rethrows the Exceptions of extractSlice.
+     */
+    Slice get(size_t t, const SliceSpec& spec, size_t lookahead = 2);
+
+    // Timesteps with a prefetch that is running or done
+    std::vector<size_t> getPrefetched() const;
+
+private:
+    std::vector<DatHeader> headers_;
+    SliceSpec spec_;
+    std::map<size_t, std::future<Slice>> prefetched_;
+};
+
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_SLICESEQUENCE_H
@@ -0,0 +1,103 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VALIDITYMASK_H
+#define IVW_VALIDITYMASK_H
+
+#include <modules/tnm067lab3/tnm067lab3moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace inviwo {
+namespace TNM067 {
+
+/**
+ * One bit per sample of a field telling whether the sample holds data. It is filled in while
+ * the field is read, see readLayer, so the kernels can skip samples that hold a no data
+ * sentinel without a separate pass to clean the field. An empty mask means that every sample
+ * is valid. Samples are grouped in words of 64, invalidating samples of the same word from
+ * different threads is not safe.
+ */
+class ValidityMask {
+public:
+    ValidityMask() = default;
+    // size samples, all valid
+    explicit ValidityMask(size_t size) { reset(size); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    bool operator[](size_t i) const {
+        return words_.empty() || ((words_[i >> 6] >> (i & 63)) & 1) != 0;
+    }
+    void invalidate(size_t i) { words_[i >> 6] &= ~(std::uint64_t(1) << (i & 63)); }
+
+    // Makes the mask size samples long, all valid
+    void reset(size_t size) {
+        size_ = size;
+        words_.assign((size + 63) / 64, ~std::uint64_t(0));
+    }
+
+    size_t countInvalid() const {
+        size_t valid = 0;
+        for (auto word : words_) valid += std::bitset<64>(word).count();
+        // The unused bits of the last word are set
+        return words_.size() * 64 - valid;
+    }
+
+private:
+    size_t size_ = 0;
+    std::vector<std::uint64_t> words_;
+};
+
+/**
+ * Whether v holds data: all components are finite and none of them is noData. An infinite
+ * noData means that the field has no sentinel and only non finite values are invalid.
+ */
+inline bool isValidSample(float v, float noData) { return std::isfinite(v) && v != noData; }
+inline bool isValidSample(vec2 v, float noData) {
+    return isValidSample(v.x, noData) && isValidSample(v.y, noData);
+}
+inline bool isValidSample(vec3 v, float noData) {
+    return isValidSample(v.x, noData) && isValidSample(v.y, noData) &&
+           isValidSample(v.z, noData);
+}
+inline bool isValidSample(vec4 v, float noData) {
+    return isValidSample(v.x, noData) && isValidSample(v.y, noData) &&
+           isValidSample(v.z, noData) && isValidSample(v.w, noData);
+}
+
+}  // namespace TNM067
+}  // namespace inviwo
+
+#endif  // IVW_VALIDITYMASK_H